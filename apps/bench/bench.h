@@ -0,0 +1,44 @@
+
+#ifndef COSAS_BENCH_H
+#define COSAS_BENCH_H
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+
+#include "cosas/source.h"
+
+
+// time n calls of f (after a short warm up) and print ns per call
+
+inline double bench(const std::string& name, size_t n, const std::function<void()>& f) {
+  for (size_t i = 0; i < n / 10; i++) f();
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < n; i++) f();
+  const std::chrono::duration<double, std::nano> ns = std::chrono::steady_clock::now() - start;
+  const double per = ns.count() / static_cast<double>(n);
+  printf("%-40s %10.1f ns\n", name.c_str(), per);
+  return per;
+}
+
+inline double bench(const std::string& name, size_t n, RelSource& src) {
+  volatile int16_t sink = 0;
+  return bench(name, n, [&]() {sink = src.next(0);});
+}
+
+
+// each file registers one group
+
+void bench_blep();
+void bench_decimate();
+void bench_delay();
+void bench_fm_fb();
+void bench_knobs();
+void bench_noise();
+void bench_random();
+void bench_operators();
+void bench_xqria();
+
+
+#endif
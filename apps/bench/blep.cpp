@@ -0,0 +1,24 @@
+
+#include "cosas/oscillator_new.h"
+#include "cosas/wavelib.h"
+
+#include "bench.h"
+
+
+// naive wavetable square and saw (via wavedex) against the band limited
+// analytic versions.
+
+void bench_blep() {
+  constexpr size_t N = SAMPLE_RATE;
+  Wavelib w;
+  AbsDexOsc sq(440, w, w.square_duty_05);
+  bench("blep wavedex square", N, sq);
+  AbsDexOsc saw(440, w, w.saw_start + 4);
+  bench("blep wavedex saw", N, saw);
+  BlepSquare bsq(440, 0.5f);
+  bench("blep square", N, bsq);
+  BlepSaw bsaw(440, 1);
+  bench("blep saw", N, bsaw);
+  BlepSaw btri(440, 0.5f);
+  bench("blep saw (offset 0.5, polyblamp)", N, btri);
+}
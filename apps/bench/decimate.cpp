@@ -0,0 +1,37 @@
+
+#include <array>
+
+#include "cosas/filter.h"
+
+#include "bench.h"
+
+
+// per output cost of the adc decimators (Codec) for 2x and 8x oversampling.
+// box is the plain average they can replace.
+
+template<size_t RATE_BITS> static void bench_rate(const char* label) {
+  constexpr size_t N = 1 << 20;
+  std::array<uint16_t, 4 << RATE_BITS> block{};
+  for (size_t i = 0; i < block.size(); i++) block[i] = static_cast<uint16_t>((i * 1237) & 0xfff);
+  volatile uint16_t sink = 0;
+  bench(std::string("decimate box ") + label, N, [&]() {
+    uint32_t sum = 0;
+    for (size_t i = 0; i < (1u << RATE_BITS); i++) sum += block[4 * i];
+    sink = static_cast<uint16_t>(sum >> RATE_BITS);
+  });
+  Cic<3, RATE_BITS> cic;
+  bench(std::string("decimate cic ") + label, N, [&]() {sink = cic.next(block.data(), 4);});
+  HalfBand<RATE_BITS> half_band;
+  bench(std::string("decimate half band ") + label, N, [&]() {sink = half_band.next(block.data(), 4);});
+}
+
+void bench_decimate() {
+  bench_rate<1>("2x");
+  bench_rate<3>("8x");
+  OnePole<11, 5, 5> pole;
+  volatile uint16_t sink = 0;
+  uint16_t x = 0;
+  bench("decimate cv one pole", 1 << 20, [&]() {sink = pole.next(x++ & 0xfff);});
+  uint32_t old = 0;
+  bench("decimate cv old smoother", 1 << 20, [&]() {old = (21 * old + 11 * ((x++ & 0xfff) << 5)) >> 5; sink = static_cast<uint16_t>(old >> 5);});
+}
@@ -0,0 +1,21 @@
+
+#include <array>
+
+#include "cosas/delay.h"
+
+#include "bench.h"
+
+
+// per sample cost of the packed delay (single and 32 sample blocks).
+
+void bench_delay() {
+  constexpr size_t N = 1 << 20;
+  static PackedDelay<16> d;
+  volatile int16_t sink = 0;
+  int16_t x = 0;
+  bench("delay single", N, [&]() {d.write(x++ & 0x7ff); sink = d.read(44100);});
+  bench("delay frac", N, [&]() {d.write(x++ & 0x7ff); sink = d.read_frac(44100u << 16 | 0x8000);});
+  std::array<int16_t, 32> in{}, out{};
+  const double per = bench("delay block (32)", N / in.size(), [&]() {d.write(in); d.read(44100, out); sink = out[0];});
+  printf("%-40s %10.2f ns\n", "delay block (per sample)", per / static_cast<double>(in.size()));
+}
@@ -0,0 +1,42 @@
+
+#include "cosas/engine_old.h"
+#include "cosas/modulators.h"
+#include "cosas/oscillator_new.h"
+#include "cosas/transformers.h"
+
+#include "bench.h"
+
+
+// the original FM_FB graph (latch/boxcar/merge/gain/fm/merge) against the
+// feedback operator now used by the engine.
+
+void bench_fm_fb() {
+  constexpr size_t N = SAMPLE_RATE;
+  Wavelib w;
+  {
+    Latch latch;
+    Boxcar flt(latch, 1000);
+    AbsDexOsc c(440, w, w.sine_gamma_1);
+    RelDexOsc m(w, w.sine_gamma_1, c.get_freq_param(), 1, 1);
+    Merge mrg(flt, 0.5);
+    mrg.add_source(m, 1);
+    Gain g(mrg, 1.0f / (1 << (PHI_FUDGE_BITS - 4)), true);
+    FM fm(c, g);
+    Merge b(fm, 0.5);
+    b.add_source(c, 1);
+    latch.set_source(&b);
+    bench("fm_fb graph (boxcar 1000)", N, latch);
+    flt.get_len().set(2);
+    bench("fm_fb graph (boxcar 2)", N, latch);
+  }
+  {
+    AbsDexOsc c(440, w, w.sine_gamma_1);
+    FbDexOsc m(w, w.sine_gamma_1, c.get_freq_param(), 1, 1, 0.5);
+    FM fm(c, m);
+    bench("fm_fb operator (bare)", N, fm);
+  }
+  {
+    OldManager m;
+    bench("fm_fb engine", N, m.build(OldManager::FM_FB));
+  }
+}
@@ -0,0 +1,48 @@
+
+#include <algorithm>
+#include <cmath>
+
+#include "cosas/knobs.h"
+
+#include "bench.h"
+
+
+// per event cost of the fixed point knob pipeline against the float
+// version it replaced (sigmoid with powf, then powf(10, v) for log).
+
+class FloatKnob {
+public:
+  FloatKnob(float linearity, float lo, float hi) : linearity(linearity), lo(lo), hi(hi) {};
+  float handle(uint16_t now, uint16_t prev) {
+    float x1 = static_cast<float>(now - 2048) / 4095;
+    float x0 = static_cast<float>(prev - 2048) / 4095;
+    float y1 =  4.0f * (1.0f - linearity) * powf(x1, 3.0f) + linearity * x1 + 0.5f;
+    float y0 =  4.0f * (1.0f - linearity) * powf(x0, 3.0f) + linearity * x0 + 0.5f;
+    normalized = std::max(0.0f, std::min(0.999999f, normalized + (y1 - y0)));
+    return powf(10, lo + (hi - lo) * normalized);
+  }
+private:
+  float normalized = 0.5;
+  float linearity, lo, hi;
+};
+
+class Sink final : public Param {
+public:
+  Sink() : Param(1, 0, true, -2, 3) {};
+  void set(float v) override {value = v;}
+  float get() override {return 1;}
+  volatile float value = 0;
+};
+
+
+void bench_knobs() {
+  constexpr size_t N = 1 << 20;
+  uint16_t now = 0, prev = 0;
+  const auto wiggle = [&]() {prev = now; now = (now + 37) & 0xfff;};
+  FloatKnob f(0, -2, 3);
+  volatile float sink = 0;
+  bench("knobs float", N, [&]() {wiggle(); sink = f.handle(now, prev);});
+  Sink param;
+  ParamAdapter k(param);
+  bench("knobs fixed", N, [&]() {wiggle(); KnobChange change = k.handle_knob_change(now, prev);});
+}
@@ -0,0 +1,21 @@
+
+#include <cstring>
+
+#include "bench.h"
+
+
+int main(int argc, char** argv) {
+  const char* only = argc > 1 ? argv[1] : "";
+  const auto run = [&](const char* name, void (*f)()) {
+    if (!strncmp(name, only, strlen(only))) f();
+  };
+  run("blep", bench_blep);
+  run("decimate", bench_decimate);
+  run("delay", bench_delay);
+  run("fm_fb", bench_fm_fb);
+  run("knobs", bench_knobs);
+  run("noise", bench_noise);
+  run("random", bench_random);
+  run("operators", bench_operators);
+  run("xqria", bench_xqria);
+}
@@ -0,0 +1,19 @@
+
+#include "cosas/noise.h"
+#include "cosas/oscillator_old.h"
+
+#include "bench.h"
+
+
+// the Noise wavetable (via wavedex) against streaming noise.
+
+void bench_noise() {
+  constexpr size_t N = SAMPLE_RATE;
+  Wavelib w;
+  AbsDexOsc table(1, w, w.noise_smooth_1);
+  bench("noise wavedex", N, table);
+  NoiseSource white(0);
+  bench("noise white", N, white);
+  NoiseSource smooth(4);
+  bench("noise smooth 4", N, smooth);
+}
@@ -0,0 +1,43 @@
+
+#include <array>
+
+#include "cosas/engine_small.h"
+#include "cosas/modulators.h"
+#include "cosas/operators.h"
+
+#include "bench.h"
+
+
+// a serial chain of four operators as a node graph (wavedex oscillators
+// and FM nodes) against the same chain in Operators.
+
+void bench_operators() {
+  constexpr size_t N = SAMPLE_RATE;
+  {
+    Wavelib w;
+    AbsDexOsc o0(440, w, w.sine_gamma_1);
+    RelDexOsc o1(w, w.sine_gamma_1, o0.get_freq_param(), 1, 1);
+    RelDexOsc o2(w, w.sine_gamma_1, o0.get_freq_param(), 2, 1);
+    RelDexOsc o3(w, w.sine_gamma_1, o0.get_freq_param(), 3, 1);
+    FM f2(o2, o3);
+    FM f1(o1, f2);
+    FM f0(o0, f1);
+    bench("operators graph (4 dex + 3 fm)", N, f0);
+  }
+  {
+    static constexpr std::array<float, 4> ratios = {1, 1, 2, 3};
+    static constexpr std::array<float, 4> levels = {1, 0.5f, 0.3f, 0.2f};
+    Operators o(4, 440, 0, ratios, levels, 0.25f);
+    bench("operators 4 op", N, o);
+  }
+  {
+    static constexpr std::array<float, 6> ratios = {1, 1, 2, 1, 3, 1};
+    static constexpr std::array<float, 6> levels = {1, 0.5f, 0.3f, 0.7f, 0.3f, 0.2f};
+    Operators o(6, 440, 0, ratios, levels, 0.25f);
+    bench("operators 6 op", N, o);
+  }
+  {
+    SmallManager m;
+    bench("operators FM_6_OP engine", N, m.build(SmallManager::FM_6_OP));
+  }
+}
@@ -0,0 +1,19 @@
+
+#include <array>
+
+#include "cosas/random.h"
+
+#include "bench.h"
+
+
+// per sample cost of next_int12 against block fill.
+
+void bench_random() {
+  constexpr size_t N = 1 << 20;
+  XorShift32 r(1);
+  volatile int16_t sink = 0;
+  bench("random next_int12", N, [&]() {sink = r.next_int12();});
+  std::array<int16_t, 256> block{};
+  const double per = bench("random fill (256 block)", N / block.size(), [&]() {r.fill(block); sink = block[0];});
+  printf("%-40s %10.2f ns\n", "random fill (per sample)", per / static_cast<double>(block.size()));
+}
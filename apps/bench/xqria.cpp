@@ -0,0 +1,35 @@
+
+#include <array>
+#include <string>
+
+#include "cosas/xqria.h"
+
+#include "bench.h"
+
+
+// per sample cost of each xqria drum (retriggered as needed, 2x
+// oversampling) and of the complete four voice Audio::generate at each
+// oversampling.
+
+void bench_xqria() {
+  using namespace xqria;
+  constexpr size_t N = 1 << 20;
+  static constexpr std::array<const char*, 4> names = {"kick", "snare", "ride", "crash"};
+  volatile int sink = 0;
+  for (uint i = 0; i < 4; i++) {
+    const uint amp = 0x7000 | (i & 1 ? INTERNAL_MSB : 0);
+    const uint freq = (160 << 4) | (i & 2 ? INTERNAL_MSB : 0);
+    Voice v(0, amp, freq, 0xff00, 0xff00, 0);
+    bench(std::string("xqria ") + names[i], N, [&]() {
+      if (!v.active()) v.trigger();
+      sink = v.output<1>();
+    });
+  }
+  for (uint os = 0; os < 4; os++) {
+    static Audio a;  // large (reverb)
+    a.oversample_bits = os;
+    std::array<uint8_t, 256> buffer{};
+    const double per = bench("xqria audio (256) x" + std::to_string(1 << os), N / buffer.size(), [&]() {a.generate(buffer); sink = buffer[0];});
+    printf("%-40s %10.2f ns\n", "xqria audio (per sample)", per / static_cast<double>(buffer.size()));
+  }
+}
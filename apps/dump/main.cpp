@@ -1,30 +1,74 @@
 
-#include <memory>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <string>
+#include <unistd.h>
 
 #include "cosas/constants.h"
-#include "cosas/engine_old.h"
-#include "cosas/engine_small.h"
 
-#include "console.h"
+#include "render.h"
+#include "writer.h"
 
 
-int main() {
-  //  dump_w_gain(Manager::Engine::FM_FB, 0.1 * sample_rate);
-  //  dump(Manager::Engine::CHORD, 0.1 * sample_rate);};
-  //  dump_w_gain(Manager::Engine::FM_SIMPLE, 0.1 * sample_rate);
-  // dump_w_wdex(OldManager::OldEngine::FM_SIMPLE, 0.1 * SAMPLE_RATE);
-  // dump(Manager::Engine::DEX, QUARTER_TABLE_SIZE);
-  // dump(Manager::Engine::POLY, QUARTER_TABLE_SIZE);
-  //  for (size_t asym = 0; asym <= PolyTable::n_shapes; ++asym) {
-  //    dump_poly(440, PolyTable::sine, asym, quarter_table_size/2);
-  //  }
-  //  dump_poly(440, PolyTable::square, 0, quarter_table_size);
-  //  dump_poly(10, PolyTable::linear - 1, PolyTable::n_shapes, 0.1 * quarter_table_size, 0.1 * full_table_size);
-  //  Wavelib w = Wavelib();
-  //  dump_dex(440, w, w.sine_gamma_1);
-  //  dump(Manager::Engine::FM_SIMPLE, 0.1 * sample_rate);
-  //  dump_w_gain(Manager::Engine::FM_ENV, 0.3 * sample_rate);
-  // dump_w_top(Manager::Engine::CHORD, 0.3 * SAMPLE_RATE, 1); // weight of first overtone
-  // dump_small(SmallManager::POLY, HALF_TABLE_SIZE);
-  dump_fome(0.01 * FULL_TABLE_SIZE, 1);
+// render an engine to wav, raw int16 or text.  eg
+//   dump -m small -e SIMPLE_2_OSC_FM -d 2.5 -p 0,main,110,880 -o fm.wav
+//   dump -m xqria -e X2 -d 10 -o drums.wav
+// (the old dump_* functions in console.cpp are still available for
+// one-off experiments)
+
+static void usage(const char* name) {
+  fprintf(stderr,
+          "usage: %s [-m small|old|xqria] [-e engine] [-d seconds | -n samples] [-b block]\n"
+          "          [-p page,knob,start[,end]]... [-f wav|raw|text] [-o file|-] [-l] [-r] [-q]\n"
+          "  -p ramps a param (knob is main, x or y) linearly over the render\n"
+          "  -l lists engines (xqria engines are oversampling, from a base rate of 40kHz)\n"
+          "  -r reports oscillator evaluations per sample for each engine\n", name);
+}
+
+int main(int argc, char** argv) {
+  try {
+    RenderSpec spec;
+    std::string path = "-";
+    std::string format;
+    bool quiet = false;
+    float seconds = -1;
+    int opt;
+    while ((opt = getopt(argc, argv, "m:e:d:n:b:p:f:o:lrqh")) != -1) {
+      switch (opt) {
+      case 'm': spec.manager = optarg; break;
+      case 'e': spec.engine = optarg; break;
+      case 'd': seconds = std::stof(optarg); break;
+      case 'n': spec.n_samples = std::stoul(optarg); break;
+      case 'b': spec.block = std::stoul(optarg); break;
+      case 'p': spec.ramps.push_back(Ramp::parse(optarg)); break;
+      case 'f': format = optarg; break;
+      case 'o': path = optarg; break;
+      case 'l': list_engines(stdout); return 0;
+      case 'r': report_evals(stdout, spec.n_samples); return 0;
+      case 'q': quiet = true; break;
+      default: usage(argv[0]); return opt == 'h' ? 0 : 1;
+      }
+    }
+    const uint32_t rate = sample_rate(spec);
+    if (seconds >= 0) spec.n_samples = static_cast<size_t>(seconds * static_cast<float>(rate));
+    if (format.empty()) format = path.ends_with(".wav") ? "wav" : path.ends_with(".raw") ? "raw" : "text";
+    const auto start = std::chrono::steady_clock::now();
+    size_t n;
+    {
+      SampleWriter writer(path, SampleWriter::parse_format(format), spec.n_samples, rate);
+      n = render(spec, writer);
+      writer.finish();  // flush before timing
+    }
+    const std::chrono::duration<float> secs = std::chrono::steady_clock::now() - start;
+    if (!quiet) {
+      const float audio = static_cast<float>(n) / static_cast<float>(rate);
+      fprintf(stderr, "%zu samples (%.2fs) in %.3fs, %.1fx real time\n",
+              n, static_cast<double>(audio), static_cast<double>(secs.count()),
+              static_cast<double>(audio / secs.count()));
+    }
+  } catch (std::exception& e) {
+    fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
 }
@@ -0,0 +1,138 @@
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+
+#include "cosas/engine_old.h"
+#include "cosas/engine_small.h"
+#include "cosas/xqria.h"
+
+#include "render.h"
+
+
+static constexpr std::array<std::string_view, OldManager::N_ENGINE> OLD_NAMES =
+  {"DEX", "POLY", "FM_SIMPLE", "FM_LFO", "FM_ENV", "FM_FB", "CHORD"};
+static constexpr std::array<std::string_view, SmallManager::N_ENGINE> SMALL_NAMES =
+  {"OSCILLATOR", "SIMPLE_2_OSC_FM", "FM_4_OP", "FM_6_OP"};
+static constexpr std::array<std::string_view, 4> XQRIA_NAMES = {"X1", "X2", "X4", "X8"};  // oversampling
+
+
+template<size_t N> size_t lookup(const std::array<std::string_view, N>& names, const std::string& engine) {
+  for (size_t i = 0; i < N; i++) if (names[i] == engine) return i;
+  size_t used = 0;
+  size_t idx = N;
+  try {idx = std::stoul(engine, &used);} catch (std::logic_error&) {}
+  if (used != engine.size() || idx >= N) throw std::invalid_argument("unknown engine " + engine);
+  return idx;
+}
+
+Ramp Ramp::parse(const std::string& spec) {
+  std::stringstream ss(spec);
+  std::string field;
+  std::vector<std::string> fields;
+  while (std::getline(ss, field, ',')) fields.push_back(field);
+  if (fields.size() < 3 || fields.size() > 4) throw std::invalid_argument("bad ramp " + spec);
+  Knob knob;
+  if (fields[1] == "main") knob = Main;
+  else if (fields[1] == "x") knob = X;
+  else if (fields[1] == "y") knob = Y;
+  else throw std::invalid_argument("bad knob " + fields[1]);
+  const float start = std::stof(fields[2]);
+  const float end = fields.size() == 4 ? std::stof(fields[3]) : start;
+  return {std::stoul(fields[0]), knob, start, end};
+}
+
+// the manager must outlive the source so both are built here
+static size_t render(BaseManager& manager, RelSource& source, const RenderSpec& spec,
+                     const std::function<void(std::span<const int16_t>)>& out) {
+  std::vector<Param*> params;
+  for (const Ramp& ramp : spec.ramps) {
+    if (ramp.page >= manager.n_panes()) throw std::invalid_argument("no pane " + std::to_string(ramp.page));
+    params.push_back(&manager.get_pane(ramp.page).get_param(ramp.knob));
+  }
+  std::vector<int16_t> block(spec.block);
+  size_t done = 0;
+  while (done < spec.n_samples) {
+    const float k = static_cast<float>(done) / static_cast<float>(spec.n_samples);
+    for (size_t i = 0; i < params.size(); i++) {
+      params[i]->set(spec.ramps[i].start + k * (spec.ramps[i].end - spec.ramps[i].start));
+    }
+    const size_t n = std::min(spec.block, spec.n_samples - done);
+    for (size_t i = 0; i < n; i++) block[i] = source.next(0);
+    out({block.data(), n});
+    done += n;
+  }
+  return done;
+}
+
+// the 8 bit dac samples are shifted to 12 bits
+static size_t render_xqria(const RenderSpec& spec, const std::function<void(std::span<const int16_t>)>& out) {
+  if (!spec.ramps.empty()) throw std::invalid_argument("xqria has no params");
+  const auto audio = std::make_unique<xqria::Audio>();  // large (reverb)
+  audio->oversample_bits = static_cast<xqria::uint>(lookup(XQRIA_NAMES, spec.engine));
+  std::vector<uint8_t> dac(spec.block);
+  std::vector<int16_t> block(spec.block);
+  size_t done = 0;
+  while (done < spec.n_samples) {
+    const size_t n = std::min(spec.block, spec.n_samples - done);
+    audio->generate({dac.data(), n});
+    for (size_t i = 0; i < n; i++) block[i] = std::max(SAMPLE_MIN, static_cast<int16_t>((dac[i] - 0x80) << (SAMPLE_BITS - 8)));
+    out({block.data(), n});
+    done += n;
+  }
+  return done;
+}
+
+size_t render(const RenderSpec& spec, const std::function<void(std::span<const int16_t>)>& out) {
+  if (spec.block == 0) throw std::invalid_argument("zero block size");
+  if (spec.manager == "xqria") return render_xqria(spec, out);
+  if (spec.manager == "old") {
+    OldManager m;
+    RelSource& src = m.build(static_cast<OldManager::OldEngine>(lookup(OLD_NAMES, spec.engine)));
+    return render(m, src, spec, out);
+  } else if (spec.manager == "small") {
+    SmallManager m;
+    RelSource& src = m.build(static_cast<SmallManager::SmallEngine>(lookup(SMALL_NAMES, spec.engine)));
+    return render(m, src, spec, out);
+  }
+  throw std::invalid_argument("unknown manager " + spec.manager);
+}
+
+size_t render(const RenderSpec& spec, SampleWriter& writer) {
+  return render(spec, [&](std::span<const int16_t> block) {writer.write(block);});
+}
+
+uint32_t sample_rate(const RenderSpec& spec) {
+  if (spec.manager == "xqria") return xqria::Rate(static_cast<xqria::uint>(lookup(XQRIA_NAMES, spec.engine))).sample_rate_hz;
+  return SAMPLE_RATE;
+}
+
+void list_engines(FILE* out) {
+  for (size_t i = 0; i < SMALL_NAMES.size(); i++) fprintf(out, "small %zu %s\n", i, SMALL_NAMES[i].data());
+  for (size_t i = 0; i < OLD_NAMES.size(); i++) fprintf(out, "old %zu %s\n", i, OLD_NAMES[i].data());
+  for (size_t i = 0; i < XQRIA_NAMES.size(); i++) fprintf(out, "xqria %zu %s\n", i, XQRIA_NAMES[i].data());
+}
+
+static void report_evals(FILE* out, const char* manager, std::string_view name, BaseManager& m, RelSource& src, size_t n) {
+  for (size_t i = 0; i < n; i++) (void)src.next(0);
+  const EvalStats s = m.get_eval_stats();
+  const auto per = [&](uint32_t x) {return static_cast<double>(x) / s.frames;};
+  fprintf(out, "%-5s %-15s %6.2f %6.2f %6.2f\n", manager, name.data(), per(s.evals), per(s.repeats), per(s.shared_hits));
+}
+
+void report_evals(FILE* out, const size_t n_samples) {
+  fprintf(out, "per sample:                evals repeat shared\n");
+  for (size_t i = 0; i < SMALL_NAMES.size(); i++) {
+    SmallManager m;
+    RelSource& src = m.build(static_cast<SmallManager::SmallEngine>(i));
+    report_evals(out, "small", SMALL_NAMES[i], m, src, n_samples);
+  }
+  for (size_t i = 0; i < OLD_NAMES.size(); i++) {
+    OldManager m;
+    RelSource& src = m.build(static_cast<OldManager::OldEngine>(i));
+    report_evals(out, "old", OLD_NAMES[i], m, src, n_samples);
+  }
+}
@@ -0,0 +1,45 @@
+
+#ifndef COSAS_RENDER_H
+#define COSAS_RENDER_H
+
+#include <functional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "cosas/common.h"
+#include "cosas/constants.h"
+
+#include "writer.h"
+
+
+// a param (knob on a pane) moved linearly from start to end over the render.
+// values are in param units (eg Hz for frequency), updated once per block.
+
+struct Ramp {
+  size_t page;
+  Knob knob;
+  float start;
+  float end;
+  static Ramp parse(const std::string& spec);  // page,knob,start[,end]
+};
+
+
+struct RenderSpec {
+  std::string manager = "small";  // small, old or xqria (drums, which has no params)
+  std::string engine = "0";  // index or name
+  size_t n_samples = SAMPLE_RATE;
+  size_t block = 256;
+  std::vector<Ramp> ramps;
+};
+
+
+// each render builds its own manager, so renders can run in parallel
+size_t render(const RenderSpec& spec, const std::function<void(std::span<const int16_t>)>& out);
+size_t render(const RenderSpec& spec, SampleWriter& writer);
+uint32_t sample_rate(const RenderSpec& spec);  // SAMPLE_RATE except for xqria
+void list_engines(FILE* out);
+void report_evals(FILE* out, size_t n_samples);  // oscillator evaluations per engine
+
+
+#endif
@@ -0,0 +1,98 @@
+
+#include <bit>
+#include <stdexcept>
+
+#include "cosas/constants.h"
+
+#include "writer.h"
+
+
+SampleWriter::SampleWriter(const std::string& path, Format format, size_t n_samples, const uint32_t rate)
+  : out(path == "-" ? stdout : fopen(path.c_str(), "wb")), path(path), close(path != "-"), format(format),
+    n_samples(n_samples), buffer(BUFFER_SIZE) {
+  if (!out) throw std::runtime_error("cannot open " + path);
+  // only our own file: stdout outlives buffer (it is flushed again at exit)
+  if (close) setvbuf(out, buffer.data(), _IOFBF, buffer.size());
+  if (format == WAV) write_wav_header(n_samples, rate);
+}
+
+// errors here are lost (see finish())
+SampleWriter::~SampleWriter() {
+  if (!out) return;
+  fflush(out);
+  if (close) fclose(out);
+}
+
+void SampleWriter::finish() {
+  if (format == WAV && written != n_samples) throw std::runtime_error("wav header does not match samples in " + path);
+  FILE* f = out;
+  out = nullptr;
+  const bool ok = fflush(f) == 0 && !ferror(f);
+  if ((close && fclose(f) != 0) || !ok) throw std::runtime_error("error writing " + path);
+}
+
+void SampleWriter::put(const void* data, const size_t size, const size_t n) {
+  if (fwrite(data, size, n, out) != n) throw std::runtime_error("short write to " + path);
+}
+
+SampleWriter::Format SampleWriter::parse_format(const std::string& name) {
+  if (name == "wav") return WAV;
+  if (name == "raw") return RAW;
+  if (name == "text") return TEXT;
+  throw std::invalid_argument("unknown format " + name);
+}
+
+void SampleWriter::write(std::span<const int16_t> block) {
+  switch (format) {
+  case WAV:
+    // scale 12 bits to 16 bits (wav is little endian)
+    scaled.resize(block.size());
+    for (size_t i = 0; i < block.size(); i++) {
+      auto s = static_cast<uint16_t>(block[i] << (16 - SAMPLE_BITS));
+      if constexpr (std::endian::native == std::endian::big) s = static_cast<uint16_t>((s >> 8) | (s << 8));
+      scaled[i] = static_cast<int16_t>(s);
+    }
+    put(scaled.data(), sizeof(int16_t), scaled.size());
+    break;
+  case RAW:
+    put(block.data(), sizeof(int16_t), block.size());
+    break;
+  case TEXT:
+    for (size_t i = 0; i < block.size(); i++) {
+      if (fprintf(out, "%zu %d\n", written + i, block[i]) < 0) throw std::runtime_error("short write to " + path);
+    }
+    break;
+  }
+  written += block.size();
+}
+
+size_t SampleWriter::get_written() const {
+  return written;
+}
+
+void SampleWriter::write_wav_header(const size_t n_samples, const uint32_t rate) {
+  const auto data = static_cast<uint32_t>(n_samples * sizeof(int16_t));
+  put("RIFF", 1, 4);
+  put_u32(36 + data);
+  put("WAVEfmt ", 1, 8);
+  put_u32(16);  // fmt chunk size
+  put_u16(1);  // pcm
+  put_u16(1);  // mono
+  put_u32(rate);
+  put_u32(rate * sizeof(int16_t));  // byte rate
+  put_u16(sizeof(int16_t));  // block align
+  put_u16(16);  // bits per sample
+  put("data", 1, 4);
+  put_u32(data);
+}
+
+void SampleWriter::put_u32(const uint32_t v) {
+  const uint8_t b[4] = {static_cast<uint8_t>(v), static_cast<uint8_t>(v >> 8),
+                        static_cast<uint8_t>(v >> 16), static_cast<uint8_t>(v >> 24)};
+  put(b, 1, 4);
+}
+
+void SampleWriter::put_u16(const uint16_t v) {
+  const uint8_t b[2] = {static_cast<uint8_t>(v), static_cast<uint8_t>(v >> 8)};
+  put(b, 1, 2);
+}
@@ -0,0 +1,55 @@
+
+#ifndef COSAS_WRITER_H
+#define COSAS_WRITER_H
+
+#include <cstdio>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "cosas/constants.h"
+
+
+// buffered block output of samples as wav (16 bit mono), raw int16
+// (native endian, unscaled 12 bit values) or "i amp" text.
+// the number of samples must be known in advance so that the wav header
+// can be written first and the output streamed (stdout works too).
+// every write is checked (short writes throw); call finish() at the end
+// to flush and close with errors reported.
+
+class SampleWriter {
+
+public:
+
+  enum Format {WAV, RAW, TEXT};
+  static constexpr size_t BUFFER_SIZE = 1 << 16;
+
+  SampleWriter(const std::string& path, Format format, size_t n_samples, uint32_t rate = SAMPLE_RATE);
+  ~SampleWriter();
+  SampleWriter(const SampleWriter&) = delete;
+  SampleWriter& operator=(const SampleWriter&) = delete;
+  void write(std::span<const int16_t> block);
+  void finish();
+  [[nodiscard]] size_t get_written() const;
+  static Format parse_format(const std::string& name);
+
+private:
+
+  void write_wav_header(size_t n_samples, uint32_t rate);
+  void put_u32(uint32_t v);
+  void put_u16(uint16_t v);
+  void put(const void* data, size_t size, size_t n);
+
+  FILE* out;
+  std::string path;
+  bool close;
+  Format format;
+  size_t n_samples;
+  size_t written = 0;
+  std::vector<char> buffer;
+  std::vector<int16_t> scaled;
+
+};
+
+
+#endif
@@ -0,0 +1,63 @@
+
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+#include "cosas/constants.h"
+
+#include "sweep.h"
+
+
+// render every combination of some params, in parallel.  eg
+//   sweep -e FM_4_OP -d 0.1 -a 1,main,1,8,8 -a 2,main,0.5,4,8,log -o fm
+// writes fm.bin and fm.csv (see sweep.h and README.md)
+
+static void usage(const char* name) {
+  fprintf(stderr,
+          "usage: %s [-m small|old] [-e engine] [-d seconds | -n samples] [-b block]\n"
+          "          [-p page,knob,start[,end]]... [-a page,knob,lo,hi,n[,log]]... [-j threads] [-o path] [-q]\n"
+          "  -a adds an axis (knob is main, x or y); every combination is rendered\n"
+          "  -p ramps a param in every render (as dump)\n"
+          "  -j defaults to the number of cores\n", name);
+}
+
+int main(int argc, char** argv) {
+  try {
+    SweepSpec spec;
+    spec.render.n_samples = SAMPLE_RATE / 10;
+    std::string path = "sweep";
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    bool quiet = false;
+    int opt;
+    while ((opt = getopt(argc, argv, "m:e:d:n:b:p:a:j:o:qh")) != -1) {
+      switch (opt) {
+      case 'm': spec.render.manager = optarg; break;
+      case 'e': spec.render.engine = optarg; break;
+      case 'd': spec.render.n_samples = static_cast<size_t>(std::stof(optarg) * SAMPLE_RATE); break;
+      case 'n': spec.render.n_samples = std::stoul(optarg); break;
+      case 'b': spec.render.block = std::stoul(optarg); break;
+      case 'p': spec.render.ramps.push_back(Ramp::parse(optarg)); break;
+      case 'a': spec.axes.push_back(Axis::parse(optarg)); break;
+      case 'j': threads = std::stoul(optarg); break;
+      case 'o': path = optarg; break;
+      case 'q': quiet = true; break;
+      default: usage(argv[0]); return opt == 'h' ? 0 : 1;
+      }
+    }
+    const auto start = std::chrono::steady_clock::now();
+    const std::vector<Stats> stats = sweep(spec, path, threads);
+    const std::chrono::duration<float> secs = std::chrono::steady_clock::now() - start;
+    if (!quiet) {
+      const float audio = static_cast<float>(stats.size() * spec.render.n_samples) / SAMPLE_RATE;
+      fprintf(stderr, "%zu renders (%.2fs audio) on %zu threads in %.3fs, %.1fx real time\n",
+              stats.size(), static_cast<double>(audio), threads, static_cast<double>(secs.count()),
+              static_cast<double>(audio / secs.count()));
+    }
+  } catch (std::exception& e) {
+    fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+}
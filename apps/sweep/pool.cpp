@@ -0,0 +1,76 @@
+
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "pool.h"
+
+
+namespace {
+
+  class Queue {
+  public:
+    void push(size_t i) {
+      std::lock_guard lock(mutex);
+      tasks.push_back(i);
+    }
+    std::optional<size_t> pop() {
+      std::lock_guard lock(mutex);
+      if (tasks.empty()) return std::nullopt;
+      const size_t i = tasks.back();
+      tasks.pop_back();
+      return i;
+    }
+    std::optional<size_t> steal() {
+      std::lock_guard lock(mutex);
+      if (tasks.empty()) return std::nullopt;
+      const size_t i = tasks.front();
+      tasks.pop_front();
+      return i;
+    }
+  private:
+    std::mutex mutex;
+    std::deque<size_t> tasks;
+  };
+
+}
+
+
+void run_stealing(const size_t n_tasks, size_t n_threads, const std::function<void(size_t)>& task) {
+  n_threads = std::max<size_t>(1, std::min(n_threads, n_tasks));
+  std::vector<std::unique_ptr<Queue>> queues;
+  for (size_t t = 0; t < n_threads; t++) queues.push_back(std::make_unique<Queue>());
+  // contiguous ranges, reversed so that each thread works through its range in order
+  for (size_t t = 0; t < n_threads; t++) {
+    const size_t lo = n_tasks * t / n_threads, hi = n_tasks * (t + 1) / n_threads;
+    for (size_t i = hi; i-- > lo; ) queues[t]->push(i);
+  }
+  std::atomic<bool> failed = false;
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  const auto worker = [&](const size_t me) {
+    while (!failed) {
+      std::optional<size_t> i = queues[me]->pop();
+      for (size_t k = 1; !i && k < n_threads; k++) i = queues[(me + k) % n_threads]->steal();
+      if (!i) return;  // nothing is added once started, so all empty means done
+      try {
+        task(*i);
+      } catch (...) {
+        std::lock_guard lock(error_mutex);
+        if (!error) error = std::current_exception();
+        failed = true;
+      }
+    }
+  };
+  {
+    std::vector<std::jthread> threads;
+    for (size_t t = 1; t < n_threads; t++) threads.emplace_back(worker, t);
+    worker(0);
+  }  // join
+  if (error) std::rethrow_exception(error);
+}
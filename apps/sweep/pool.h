@@ -0,0 +1,18 @@
+
+#ifndef COSAS_POOL_H
+#define COSAS_POOL_H
+
+#include <cstddef>
+#include <functional>
+
+
+// run task(0) .. task(n_tasks - 1) on n_threads and wait for completion.
+// each thread starts with a contiguous range of tasks (in a deque) and
+// takes from the back of its own; when empty it steals from the front of
+// the others, so uneven task costs balance out.  the first exception
+// thrown by a task is rethrown here (remaining tasks are skipped).
+
+void run_stealing(size_t n_tasks, size_t n_threads, const std::function<void(size_t)>& task);
+
+
+#endif
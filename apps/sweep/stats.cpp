@@ -0,0 +1,33 @@
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "cosas/constants.h"
+
+#include "analysis.h"
+#include "stats.h"
+
+
+Stats Stats::of(const std::span<const int16_t> samples) {
+  Stats s{0, 0, 0};
+  if (samples.empty()) return s;
+  double sum2 = 0;
+  int peak = 0;
+  for (const int16_t v : samples) {
+    sum2 += v * static_cast<double>(v);
+    peak = std::max(peak, std::abs(static_cast<int>(v)));
+  }
+  s.rms = static_cast<float>(sqrt(sum2 / static_cast<double>(samples.size()))) / SAMPLE_MAX;
+  s.peak = static_cast<float>(peak) / SAMPLE_MAX;
+  if (samples.size() < 2) return s;
+  const std::vector<double> power = power_spectrum(samples);
+  const double bin_hz = SAMPLE_RATE / (2.0 * static_cast<double>(power.size() - 1));
+  double weighted = 0, total = 0;
+  for (size_t k = 1; k < power.size(); k++) {
+    weighted += power[k] * static_cast<double>(k) * bin_hz;
+    total += power[k];
+  }
+  if (total > 0) s.centroid = static_cast<float>(weighted / total);
+  return s;
+}
@@ -0,0 +1,21 @@
+
+#ifndef COSAS_STATS_H
+#define COSAS_STATS_H
+
+#include <cstdint>
+#include <span>
+
+
+// summary of a render.  rms and peak are fractions of SAMPLE_MAX.  the
+// centroid (Hz, power weighted, excluding dc) is from power_spectrum (see
+// analysis.h).
+
+struct Stats {
+  float rms;
+  float peak;
+  float centroid;
+  static Stats of(std::span<const int16_t> samples);
+};
+
+
+#endif
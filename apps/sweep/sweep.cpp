@@ -0,0 +1,94 @@
+
+#include <cmath>
+#include <cstdio>
+#include <fcntl.h>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+
+#include "pool.h"
+#include "sweep.h"
+
+
+Axis Axis::parse(const std::string& spec) {
+  std::stringstream ss(spec);
+  std::string field;
+  std::vector<std::string> fields;
+  while (std::getline(ss, field, ',')) fields.push_back(field);
+  if (fields.size() < 5 || fields.size() > 6) throw std::invalid_argument("bad axis " + spec);
+  if (fields.size() == 6 && fields[5] != "log") throw std::invalid_argument("bad axis " + spec);
+  // reuse the knob parsing
+  const Ramp r = Ramp::parse(fields[0] + "," + fields[1] + "," + fields[2] + "," + fields[3]);
+  const size_t n = std::stoul(fields[4]);
+  if (n == 0) throw std::invalid_argument("empty axis " + spec);
+  const bool log = fields.size() == 6;
+  if (log && (r.start <= 0 || r.end <= 0)) throw std::invalid_argument("log axis must be positive " + spec);
+  return {r.page, r.knob, r.start, r.end, n, log};
+}
+
+float Axis::value(const size_t i) const {
+  if (n == 1) return lo;
+  const float k = static_cast<float>(i) / static_cast<float>(n - 1);
+  return log ? lo * powf(hi / lo, k) : lo + k * (hi - lo);
+}
+
+std::string Axis::name() const {
+  return std::to_string(page) + (knob == Main ? "main" : knob == X ? "x" : "y");
+}
+
+
+size_t SweepSpec::n_renders() const {
+  size_t n = 1;
+  for (const Axis& a : axes) n *= a.n;
+  return n;
+}
+
+std::vector<float> SweepSpec::values(size_t idx) const {
+  std::vector<float> v(axes.size());
+  for (size_t i = axes.size(); i-- > 0; ) {
+    v[i] = axes[i].value(idx % axes[i].n);
+    idx /= axes[i].n;
+  }
+  return v;
+}
+
+
+std::vector<Stats> sweep(const SweepSpec& spec, const std::string& path, const size_t n_threads) {
+  const size_t n = spec.n_renders();
+  const size_t bytes = spec.render.n_samples * sizeof(int16_t);
+  const int fd = open((path + ".bin").c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+  if (fd < 0) throw std::runtime_error("cannot open " + path + ".bin");
+  std::vector<Stats> stats(n);
+  try {
+    run_stealing(n, n_threads, [&](const size_t i) {
+      RenderSpec r = spec.render;
+      const std::vector<float> v = spec.values(i);
+      for (size_t a = 0; a < v.size(); a++) r.ramps.push_back({spec.axes[a].page, spec.axes[a].knob, v[a], v[a]});
+      std::vector<int16_t> samples;
+      samples.reserve(r.n_samples);
+      render(r, [&](std::span<const int16_t> block) {samples.insert(samples.end(), block.begin(), block.end());});
+      stats[i] = Stats::of(samples);
+      // each render has its own region of the file
+      if (pwrite(fd, samples.data(), bytes, static_cast<off_t>(i * bytes)) != static_cast<ssize_t>(bytes)) {
+        throw std::runtime_error("short write to " + path + ".bin");
+      }
+    });
+  } catch (...) {
+    close(fd);
+    throw;
+  }
+  close(fd);
+  FILE* csv = fopen((path + ".csv").c_str(), "w");
+  if (!csv) throw std::runtime_error("cannot open " + path + ".csv");
+  fprintf(csv, "index");
+  for (const Axis& a : spec.axes) fprintf(csv, ",%s", a.name().c_str());
+  fprintf(csv, ",rms,peak,centroid\n");
+  for (size_t i = 0; i < n; i++) {
+    fprintf(csv, "%zu", i);
+    for (const float v : spec.values(i)) fprintf(csv, ",%g", static_cast<double>(v));
+    fprintf(csv, ",%.4f,%.4f,%.1f\n", static_cast<double>(stats[i].rms), static_cast<double>(stats[i].peak),
+            static_cast<double>(stats[i].centroid));
+  }
+  fclose(csv);
+  return stats;
+}
@@ -0,0 +1,42 @@
+
+#ifndef COSAS_SWEEP_H
+#define COSAS_SWEEP_H
+
+#include <string>
+#include <vector>
+
+#include "render.h"
+#include "stats.h"
+
+
+// a param held at each of n values from lo to hi (linear, or log spaced)
+// for a whole render.  all combinations of all axes are rendered.
+
+struct Axis {
+  size_t page;
+  Knob knob;
+  float lo;
+  float hi;
+  size_t n;
+  bool log;
+  static Axis parse(const std::string& spec);  // page,knob,lo,hi,n[,log]
+  [[nodiscard]] float value(size_t i) const;
+  [[nodiscard]] std::string name() const;
+};
+
+
+struct SweepSpec {
+  RenderSpec render;  // ramps here apply to every render
+  std::vector<Axis> axes;
+  [[nodiscard]] size_t n_renders() const;
+  [[nodiscard]] std::vector<float> values(size_t idx) const;  // last axis varies fastest
+};
+
+
+// writes path.bin (n_renders * n_samples raw int16, native endian,
+// unscaled 12 bit values, in render order) and path.csv (index, axis
+// values, rms, peak, centroid).  returns the stats.
+std::vector<Stats> sweep(const SweepSpec& spec, const std::string& path, size_t n_threads);
+
+
+#endif
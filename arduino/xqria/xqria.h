@@ -0,0 +1 @@
+../../cosas/include/cosas/xqria.h
\ No newline at end of file
@@ -9,74 +9,47 @@
 #include "driver/dac_continuous.h"
 #include "math.h"
 #include <Preferences.h>
+#include "xqria.h"  // the dsp, which also builds on the host (links to cosas/include/cosas/xqria.h)
+#ifndef COSAS_XQRIA_H
+#error "xqria.h is not the dsp header (a link that was not followed?) - see install in README.md"
+#endif
+
+using namespace xqria;
 
 const uint DMA_BUFFER_SIZE = 4092;  // 32 to 4092, multiple of 4; padded 16 bit; audible artefacts at 256 (even 1024) and below and i don't understand why
 const uint MAX_LOCAL_BUFFER_SIZE = DMA_BUFFER_SIZE / 2;  // 8 bit
 const uint MIN_LOCAL_BUFFER_SIZE = 10;  // anything lower grinds
-const uint BASE_RATE_HZ = 40000;
-const uint INTERNAL_BITS = 16;
-const uint INTERNAL_N = 1 << INTERNAL_BITS;
-const uint INTERNAL_MAX = INTERNAL_N - 1;
-const uint INTERNAL_MSB = INTERNAL_N >> 1;
-const uint INTERNAL_NO_MSB = INTERNAL_MAX >> 1;
 const uint POT_BITS = 12;
 const uint POT_N = 1 << POT_BITS;
 const uint POT_MAX = POT_N - 1;
 const uint DAC_BITS = 8;
-const uint TABLE_BITS = 12;
-const uint TABLE_N = 1 << TABLE_BITS;
-const std::array<uint, 16> SUBDIVS = {5, 10, 12, 15, 20, 24, 25, 30, 35, 36, 40, 45, 48, 50, 55, 60};  // by luck length is power of 2
-const uint MAX_COMP_BITS = 12;
-const uint FREQ_BITS = 7;
-const uint FREQ_N = 1 << FREQ_BITS;  // 128 - 10 octaves from 20hz to 20khz, 12 notes per octave
-const uint A_IDX = 61;  // from trial and error (location of 440hz)
-const uint AMP_BITS = 7;
-const uint AMP_N = 1 << AMP_BITS;
-const uint REVERB_EXTRA = 4;
-const uint REVERB_DENOM_BITS = 12;
-
-static std::array<uint, FREQ_N> FREQ = {0};
-static std::array<uint, AMP_N> AMP = {0};
 
 const uint LED_FREQ = 1000;
 const uint LED_BITS = 8;
 const uint LED_MAX = (1 << LED_BITS) - 1;
 const uint LED_DIM_BITS = 3;
 
+// voices, patterns and post-processing (the sound); the rest of this file is the ui and dac
+static Audio AUDIO;
+static auto& VOICES = AUDIO.voices;
+static auto& VAULTS = AUDIO.vaults;
+static auto& REVERB = AUDIO.reverb;
+
 // global parameters that can be changed during use
-//volatile static uint BPM = 90;
-volatile static uint BPM = 200;
-volatile static uint SUBDIV_IDX = 15;
-volatile static uint PATT_OFFSET = 0;
-volatile static uint COMP_BITS = 0;
-volatile static uint DROP_BITS = 0;
 volatile static uint ENABLED = 10;  // all enabled (gray(10) = 9xf)
 // volatile static uint ENABLED = 1;
 volatile static uint LOCAL_BUFFER_SIZE = MAX_LOCAL_BUFFER_SIZE;  // has to be even
-volatile static uint OVERSAMPLE_BITS = 1;  // can be adjusted via sys
-
-// derived from above
-volatile static uint BEAT_SCALE = (BASE_RATE_HZ << OVERSAMPLE_BITS) * 60;  // ticks for 1 bpm
-volatile static uint SAMPLE_RATE_HZ = BASE_RATE_HZ << OVERSAMPLE_BITS;
-volatile static uint TAU_BITS = INTERNAL_BITS + 1 + OVERSAMPLE_BITS;
-volatile static uint TAU_N = 1 << TAU_BITS;
-volatile static uint TAU_MAX = TAU_N - 1;
-volatile static uint REFRESH_US = (1000000 * LOCAL_BUFFER_SIZE) / SAMPLE_RATE_HZ;
+volatile static uint REFRESH_US = (1000000 * LOCAL_BUFFER_SIZE) / AUDIO.rate().sample_rate_hz;
 
 const uint DBG_LOTTERY = 10000;
 const bool DBG_VOICE = false;
 const bool DBG_LFSR = false;
-const bool DBG_VOLUME = false;
 const bool DBG_COMP = false;
 const bool DBG_TIMING = true;
 const bool DBG_BEEP = false;
-const bool DBG_DRUM = false;
 const bool DBG_CRASH = false;
 const bool DBG_MINIFM = false;
 const bool DBG_REVERB = false;
-const bool DBG_EUCLIDEAN = false;
-const bool DBG_JIGGLE = false;
-const bool DBG_PATTERN = false;
 const bool DBG_COPY = false;
 const bool DBG_STARTUP = true;
 const bool DBG_POT = false;
@@ -111,117 +84,6 @@ struct AllData {
   uint local_buffer_size;
 };
 
-template<typename T> int sgn(T val) {
-  return (T(0) < val) - (val < T(0));
-}
-
-inline uint umult(uint a, uint b) {
-  return (a * b) >> INTERNAL_BITS;
-}
-
-inline int imult(int a, int b) {
-  return (a * b) >> INTERNAL_BITS;
-}
-
-template<uint BITS> uint array_lookup(std::array<uint, 1 << BITS> data, uint idx) {
-  return data[idx >> (INTERNAL_BITS - BITS)];
-}
-
-template<uint BITS> uint array_lookup_msb(std::array<uint, 1 << BITS> data, uint idx) {
-  return data[(idx & 0x7fff) >> (INTERNAL_BITS - 1 - BITS)];
-}
-
-uint non_linear(uint val, uint n) {
-  if (n == 0) return 1;
-  else if (n == 1) return val;
-  uint val2 = umult(val, val);
-  if (n == 2) return (val + val2) >> 1;
-  uint val3 = umult(val, val2);
-  if (n == 3) return (val + val2 + 2 * val3) >> 2;
-  uint val4 = umult(val, val3);
-  return (val + (val2 << 1) + (val3 << 2) + val4 + (val4 << 3)) >> 4;
-}
-
-// efficient random bits from an LFSR (random quality is not important here!)
-class LFSR16 {
-private:
-  uint state;
-public:
-  LFSR16(uint seed = 0xace1u) : state(seed) {}
-  int next(uint scale) {
-    uint lsb = state & 0x1;
-    state >>= 1;
-    if (lsb) {
-      state ^= 0xb400;
-      return scale;
-    } else {
-      return -scale;
-    }
-    return lsb;
-  }
-  uint get_state() {
-    next(1);
-    return state;
-  }
-};
-
-static LFSR16 LFSR;
-
-uint freq_to_phase(float f) {
-  return static_cast<uint>(0.5 + (f * TAU_N) / static_cast<float>(SAMPLE_RATE_HZ));
-}
-
-float phase_to_freq(uint offset) {
-  return (static_cast<float>(SAMPLE_RATE_HZ) * offset) / TAU_N;
-}
-
-bool in_range(int idx) {
-  return idx > -1 && idx < FREQ_N;
-}
-
-void set_freq_around(float a, int a_idx) {
-  Serial.printf("around %d %f\n", a_idx, a);
-  if (in_range(a_idx)) FREQ[a_idx] = freq_to_phase(a);
-  for (int i = 1; i < 7; i++) {
-    if (in_range(a_idx + i)) FREQ[a_idx + i] = freq_to_phase(a * pow(2.0f, i / 12.0f));
-  }
-  for (int i = 1; i < 6; i++) {
-    if (in_range(a_idx - i)) FREQ[a_idx - i] = freq_to_phase(a * pow(2.0f, -i / 12.0f));
-  }
-}
-
-void set_freq_up(float a, int a_idx) {
-  while (a_idx < FREQ_N + 12) {
-    set_freq_around(a, a_idx);
-    a *= 2;
-    a_idx += 12;
-  }
-}
-
-void set_freq_down(float a, int a_idx) {
-  while (a_idx > -12) {
-    set_freq_around(a, a_idx);
-    a /= 2;
-    a_idx -= 12;
-  }
-}
-
-void set_freq() {
-  float a = 440;
-  set_freq_down(a, A_IDX);
-  set_freq_up(a * 2, A_IDX + 12);
-  if (DBG_STARTUP) for (uint i = 0; i < FREQ_N; i++) Serial.printf("f %d %d %.1f\n", i, FREQ[i], phase_to_freq(FREQ[i]));
-}
-
-void set_amp() {
-  float k = pow(2.0f, INTERNAL_BITS / static_cast<float>(AMP_N - 1));
-  for (int i = 0; i < AMP_N; i++) {
-    // at i=AMP_N we want it to be near 1.  INTERNAL_MAX is INTERNAL_N bits, so we want 1/2^INTERNAL_N at TABLE_N
-    AMP[i] = max(0u, min(INTERNAL_MAX, static_cast<uint>(0.5f + pow(k, i))));
-  }
-  if (DBG_STARTUP) for (uint i = 0; i < AMP_N; i++) Serial.printf("a %d %d\n", i, AMP[i]);
-}
-
 // wrapper for LEDs
 // assumes values are INTERNAL_BITS and converts to LED_BITS
 class LEDs {
@@ -393,406 +255,6 @@ public:
   }
 };
 
-// quarter wave lookup (don't need to store complete sine wave; only first quarter)
-class Quarter {
-private:
-  virtual uint lookup(uint phase);
-public:
-  Quarter() = default;
-  int operator()(uint amp, uint phase) {
-    // NOTE - this all works on TAU_BITS, so lookup needs to reduce to TABLE_BITS if necessary
-    uint half = TAU_N >> 1;  // not const because TAU itself can vary
-    uint quarter = half >> 1;
-    int sign = 1;
-    if (phase >= half) {
-      phase = TAU_N - phase;
-      sign = -1;
-    };
-    if (phase >= quarter) phase = half - phase;
-    int result = sign * static_cast<int>(umult(amp, lookup(phase)));
-    return result;
-  }
-};
-
-class Lookup : public Quarter {
-protected:
-  std::array<uint16_t, 1 + TABLE_N / 4> table;
-public:
-  uint lookup(uint phase) override {
-    // phase already in first quadrant
-    return table[phase >> (TAU_BITS - TABLE_BITS)];
-  }
-};
-
-class Sine : public Lookup {
-public:
-  Sine() : Lookup() {
-    for (uint i = 0; i < 1 + (TABLE_N / 4); i++) table[i] = static_cast<uint16_t>(INTERNAL_MAX * sin(2 * PI * i / TABLE_N));
-  }
-};
-
-Sine SINE;
-
-class TriangleMinusSine : public Lookup {
-public:
-  TriangleMinusSine(double k) : Lookup() {
-    double norm = 0;
-    for (uint i = 0; i < 1 + (TABLE_N / 4); i++) {
-      norm = max(norm, (i << (INTERNAL_BITS - (TABLE_BITS - 2))) - k * INTERNAL_MAX * sin(2 * PI * i / TABLE_N));
-    }
-    norm = ((1 << 16) - 1) / norm;
-    for (uint i = 0; i < 1 + (TABLE_N / 4); i++) {
-      table[i] = static_cast<uint16_t>(norm * max(0.0, ((i << (INTERNAL_BITS - (TABLE_BITS - 2))) - k * INTERNAL_MAX * sin(2 * PI * i / TABLE_N))));
-    }
-  }
-};
-
-TriangleMinusSine TM81S(0.81);
-TriangleMinusSine TM50S(0.50);
-
-class SquareMinusSine : public Lookup {
-public:
-  SquareMinusSine(double k) : Lookup() {
-    double norm = 0;
-    for (uint i = 0; i < 1 + (TABLE_N / 4); i++) {
-      norm = max(norm, INTERNAL_MAX * (1 - k * sin(2 * PI * i / TABLE_N)));
-    }
-    norm = ((1 << 16) - 1) / norm;
-    for (uint i = 0; i < 1 + (TABLE_N / 4); i++) {
-      table[i] = static_cast<uint16_t>(norm * max(0.0, INTERNAL_MAX * (1 - k * sin(2 * PI * i / TABLE_N))));
-    }
-  }
-};
-
-SquareMinusSine SM50S(0.50);
-
-// implement square (no need for table, can just use constant)
-class Square : public Quarter {
-public:
-  Square() : Quarter() {}
-  uint lookup(uint phase) override {
-    return INTERNAL_MAX;
-  }
-};
-
-Square SQUARE;
-
-class Triangle : public Quarter {
-public:
-  Triangle() : Quarter() {}
-  uint lookup(uint phase) override {
-    // this should only be called in first quadrant and phase is between 0 and tau/4
-    if ((TAU_BITS - 2) < INTERNAL_BITS) {
-      return phase << (INTERNAL_BITS - (TAU_BITS - 2));
-    } else {
-      return phase >> ((TAU_BITS - 2) - INTERNAL_BITS);
-    }
-  }
-};
-
-Triangle TRIANGLE;
-
-int norm_phase(int phase) {
-  return phase & TAU_MAX;
-  // while (phase < 0) phase += TAU_MAX;
-  // while (phase > TAU_MAX) phase -= TAU_MAX;
-  // return phase;
-}
-
-class HiPass {
-private:
-  int prev_in = 0;
-  int prev_out = 0;
-  int alpha;
-public:
-  HiPass(int alpha) : alpha(alpha) {};
-  int next(int in, int alpha2) {
-    alpha = alpha2;
-    return next(in);
-  }
-  int next(int in) {
-    prev_out = imult(alpha, prev_out + in - prev_in);
-    prev_in = in;
-    return prev_out;
-  }
-};
-
-class LoPass {
-private:
-  int prev_out = 0;
-  int alpha;
-  int beta;
-public:
-  LoPass(int alpha) : alpha(alpha), beta(INTERNAL_MAX - alpha) {};
-  int next(int in, int alpha2) {
-    alpha = alpha2;
-    beta = INTERNAL_MAX - alpha;
-    return next(in);
-  }
-  int next(int in) {
-    prev_out = imult(alpha, in) + imult(beta, prev_out);
-    return prev_out;
-  }
-};
-
-// generate the sound for each voice (which means tracking time and phase)
-class Voice {
-private:
-  uint time = 0;  // ticks since triggered
-  int phase = 0;
-  int fm_phase = 0;
-  bool on = false;
-  HiPass hp;
-  LoPass lp;
-public:
-  uint idx;
-  // parameters madified by UI (all INTERNAL_BITS)
-  volatile uint amp;
-  volatile uint freq;
-  volatile uint durn;
-  volatile uint fm;
-  volatile int shift;
-  Voice(uint idx, uint amp, uint freq, uint durn, uint fm, int shift) 
-  : hp(INTERNAL_MAX >> 1), lp(INTERNAL_MAX >> 3), idx(idx), amp(amp), freq(freq), durn(durn), fm(fm), shift(shift) {};
-  void trigger() {
-    on = true;
-    time = 0;
-    phase = LFSR.get_state();
-    phase = 0;
-    fm_phase = 0;
-  }
-  int output() {
-    if (!on) return 0;
-    // sampling freq is 15.5 bits, internal is 16 bits, would like max durn to be about 4s.
-    uint durn_scaled = OVERSAMPLE_BITS > 1 ? non_linear(durn, 2) << (OVERSAMPLE_BITS - 1) : non_linear(durn, 2) >> (1 - OVERSAMPLE_BITS);  // currently this is not -ve
-    if (time >= durn_scaled) {
-      STATE.voice(idx, false);    
-      on = false;
-      return 0;
-    }
-    uint rise = (((INTERNAL_MAX >> 4) * time) / (durn_scaled + 1)) << 4;
-    uint dec = INTERNAL_MAX - rise;
-    uint nv_freq = freq;
-    uint exp_freq = array_lookup_msb<FREQ_BITS>(FREQ, nv_freq);
-    uint nv_amp = amp;
-    uint exp_amp = array_lookup_msb<AMP_BITS>(AMP, nv_amp);
-    int out = 0;
-    if (nv_freq & INTERNAL_MSB) {
-      if (nv_amp & INTERNAL_MSB) {
-        out = crash(exp_amp, exp_freq << 1, fm, non_linear(dec, 2));
-      } else {
-        uint env = min(rise << 1, array_lookup<AMP_BITS>(AMP, dec));
-        out = ride(exp_amp << 2, exp_freq  << 1, fm, env);
-      }
-    } else {
-      if (nv_amp & INTERNAL_MSB) {
-        out = snare(exp_amp, exp_freq >> 1, fm, dec);
-      } else {
-        out = kick(exp_amp << 2, exp_freq >> 4, fm, dec);
-      }
-    }
-    time++;
-    return out;
-  }
-  int snare(uint amp, uint freq, uint fm, uint dec) {
-    uint dec2 = umult(dec, dec);
-    fm_phase = norm_phase(fm_phase + (fm >> 6));
-    phase = norm_phase(phase + freq + SM50S(dec2 >> 6, fm_phase));
-    int xxx = TM50S(dec, phase) + LFSR.next(umult(fm, dec2) >> 2);
-    int out = imult(amp, xxx);
-    if (DBG_DRUM && !random(DBG_LOTTERY)) Serial.printf("amp %d: %d -> %d\n", amp, xxx, out);
-    return lp.next(out, dec >> 1);
-  }
-  int kick(uint amp, uint freq, uint fm, uint dec) {
-    uint dec2 = umult(dec, dec);
-    uint local_freq = freq + (umult(fm, dec2) >> 6);
-    phase = norm_phase(phase + local_freq);
-    fm_phase = norm_phase(fm_phase + (local_freq >> 3));
-    uint local_amp = umult(amp, dec);
-    return SINE(local_amp, phase) + TM50S(local_amp >> 2, fm_phase);
-  }
-  int crash(uint amp, uint freq, uint fm, uint dec) {
-    uint dec2 = umult(dec, dec);
-    fm_phase = norm_phase(fm_phase + fm);
-    phase = norm_phase(phase + freq + SM50S(dec, fm_phase) + LFSR.next(dec2 >> 2));
-    return imult(amp, SINE(dec, phase));
-  }
-  int ride(uint amp, uint freq, uint fm, uint env) {
-    fm_phase = norm_phase(fm_phase + fm);
-    phase = norm_phase(phase + freq + TRIANGLE(INTERNAL_MAX, fm_phase));
-    int out = imult(amp, SINE(env, phase) + LFSR.next(imult(fm, env) >> 4));
-    return hp.next(out, (INTERNAL_MAX - env) >> 1);
-  }
-  void to(Voice& other) {
-    other.amp = amp;
-    other.freq = freq;
-    other.durn = durn;
-    other.fm = fm;
-    other.shift = shift;
-  }
-  void to(VoiceData& other) {
-    other.amp = amp;
-    other.freq = freq;
-    other.durn = durn;
-    other.fm = fm;
-    other.shift = shift;
-  }
-  void from(VoiceData& other) {
-    amp = other.amp;
-    freq = other.freq;
-    durn = other.durn;
-    fm = other.fm;
-    shift = other.shift;
-  }
-};
-
-std::array<Voice, 4> VOICES = {Voice(0, 0xff00, 160 << 4, 0xff00, 0xff00, 0),
-                               Voice(1, 0x7fff, 240 << 4, 0xff00, 0xff00, 0),
-                               Voice(2, 0x7fff, 213 << 4, 0xff00, 0xff00, 0),
-                               Voice(3, 0x7fff, 320 << 4, 0xff00, 0xff00, 0)};
-
-// standard euclidean pattern
-class Euclidean {
-private:
-  uint n_places;
-  uint n_beats;
-  float frac_main;
-  float n_main;
-  uint prob;
-  uint voice;
-  uint current_place = 0;
-  std::vector<uint> place_ref;       // beat index -> place index (reference)
-  std::vector<uint> place_off;       // beat index -> place index (offset)
-  std::vector<int> error;            // beat index -> error x MAX12
-  std::vector<uint> index_by_error;  // error (abs(error) increasing) -> beat index
-  std::vector<bool> is_main;         // beat index -> true if main (small error)
-  std::vector<int> index_by_place;   // (offset) place index -> beat index (or -1)
-  void trigger(uint delta) {
-    uint n = voice + delta;
-    if (gray(ENABLED) & (1 << n)) {
-      VOICES[n].trigger();
-      STATE.voice(n, true);
-    }
-  }
-public:
-  // 1 <= n_beats <= n_places
-  Euclidean(uint n_places, uint n_beats, float frac_main, uint prob, uint voice)
-    : n_places(n_places), n_beats(n_beats), frac_main(max(0.0f, min(1.0f, frac_main))), prob(prob), voice(voice) {
-    for (uint i = 0; i < n_beats; i++) {
-      float x = n_places * i / static_cast<float>(n_beats);
-      place_ref.push_back(round(x));
-      place_off.push_back(round(x));
-      error.push_back(static_cast<int>(INTERNAL_MAX * (x - round(x))));
-    }
-    uint regular[n_beats] = {0};
-    int penalty = INTERNAL_MAX;
-    for (uint i = 0; i < n_beats; i++) {
-      if (error[i]) penalty = min(penalty, abs(error[i]));
-    }
-    penalty /= 2;
-    // should penalty be +ve or -ve?
-    if (random(2)) penalty = -1 * penalty;
-    for (uint i = 2; i < n_beats; i++) {
-      if (!(n_beats % i) && !(n_places % i)) {
-        for (uint j = 0; j < n_beats; j += i) regular[j] = penalty;
-        penalty /= 2;
-      }
-    }
-    for (uint i = 0; i < n_beats; i++) {
-      if (!error[i]) error[i] = regular[i];
-    }
-    index_by_error.resize(n_beats, 0);
-    std::iota(index_by_error.begin(), index_by_error.end(), 0);
-    std::sort(index_by_error.begin(), index_by_error.end(), [this](int i, int j) {
-      return abs(this->error[i]) < abs(this->error[j]);
-    });
-    // for (uint i = 0; i < n_beats; i++) Serial.printf("%d %f\n", i, error[index_by_error[i]]);
-    n_main = max(0u, min(n_beats, static_cast<uint>(round(n_beats * frac_main))));
-    is_main.resize(n_beats, false);
-    for (uint i = 0; i < n_main; i++) is_main[index_by_error[i]] = true;
-    index_by_place.resize(n_places, -1);
-    for (uint i = 0; i < n_beats; i++) index_by_place[place_off[i]] = i;
-    // for (uint i = 0; i < n_beats; i++) Serial.printf("%d: %d\n", i, place_ref[i]);
-  };
-  Euclidean() : Euclidean(2, 1, 0.5, INTERNAL_MAX, 0) {};  // used only as temp value in arrays
-  bool operator==(const Euclidean other) {
-    return other.n_places == n_places && other.n_beats == n_beats && other.n_main == n_main && other.prob == prob && other.voice == voice;
-  }
-  void jiggle() {
-    // error is signed to MAX11 (MAX12 * 0.5) while prob is unisgned MAX12
-    for (uint i = 0; i < n_beats - n_main; i++) {
-      uint frac_m12 = (prob * static_cast<uint>(abs(error[i]))) >> 11;
-      if (random(INTERNAL_MAX) < frac_m12) {
-        if (place_ref[i] == place_off[i]) {
-          if (error[i] > 0 && index_by_place[place_off[i] + 1] == -1) {
-            place_off[i]++;
-            index_by_place[place_off[i]] = i;
-            index_by_place[place_ref[i]] = -1;
-            if (DBG_JIGGLE) Serial.printf("%d: %d -> %d\n", voice, place_ref[i], place_off[i]);
-          } else if (error[i] < 0 && index_by_place[place_off[i] - 1] == -1) {
-            place_off[i]--;
-            index_by_place[place_off[i]] = i;
-            index_by_place[place_ref[i]] = -1;
-            if (DBG_JIGGLE) Serial.printf("%d: %d -> %d\n", voice, place_ref[i], place_off[i]);
-          }
-        } else {
-          if (error[i] > 0 && index_by_place[place_ref[i]] == -1) {
-            index_by_place[place_off[i]] = -1;
-            place_off[i]--;
-            index_by_place[place_ref[i]] = i;
-            if (DBG_JIGGLE) Serial.printf("%d: %d -> %d\n", voice, place_ref[i], place_off[i]);
-          } else if (error[i] < 0 && index_by_place[place_ref[i]] == -1) {
-            index_by_place[place_off[i]] = -1;
-            place_off[i]++;
-            index_by_place[place_ref[i]] = i;
-            if (DBG_JIGGLE) Serial.printf("%d: %d -> %d\n", voice, place_ref[i], place_off[i]);
-          }
-        }
-        return;
-      }
-    }
-  }
-  void on_beat(bool main) {
-    static uint nl = 0;
-    if (!nl && DBG_PATTERN) Serial.printf("\n");
-    nl = (nl + 1) & 0xff;
-    int beat = index_by_place[current_place];
-    if (beat != -1 && is_main[beat] == main) {
-      trigger(main ? 0 : 1);
-      if (DBG_PATTERN) Serial.printf("%d", voice + (main ? 0 : 1));
-    } else if (DBG_PATTERN) Serial.printf("-");
-    if (!main) {  // main is done before minor
-      if (++current_place == n_places) current_place = 0;
-    }
-  }
-};
-
-// exponential moving average used for smoothing time series
-template<typename T> class EMA {
-private:
-  uint bits;
-  uint denom;
-  uint xtra;
-  T state;
-protected:
-  virtual T get_state() {
-    return state;
-  }
-  virtual void set_state(T s) {
-    state = s;
-  }
-public:
-  uint num;
-  EMA(uint bits, uint num, uint xtra, T state) : bits(bits), denom(1 << bits), xtra(xtra), state(state << xtra), num(num){};
-  T next(T val) {
-    set_state((get_state() * static_cast<T>(denom - num) + (val << xtra) * static_cast<T>(num)) >> bits);
-    return read();
-  }
-  T read() {
-    return get_state() >> xtra;
-  }
-};
-
 // encapsulate a pot position and associated (smoothed) state
 class Pot {
 private:
@@ -959,10 +421,6 @@ protected:
   }
 };
 
-uint gray(uint n) {
-  return n ^ (n >> 1);
-}
-
 // subclass button to edit voice parameters
 class VoiceButton : public Button, public PotsReader {
 private:
@@ -1000,9 +458,9 @@ public:
   TimingButtons() = default;
   void read_state() {
     if (STATE.button_mask == 0x6) {
-      update(&BPM, 30, -6, 0);
-      update_subdiv(&SUBDIV_IDX, 1);
-      update_bin(&PATT_OFFSET, 2);
+      update(&AUDIO.timing.bpm, 30, -6, 0);
+      update_subdiv(&AUDIO.timing.subdiv_idx, 1);
+      update_bin(&AUDIO.timing.patt_offset, 2);
     } else {
       disable();
     }
@@ -1011,56 +469,6 @@ public:
 
 static TimingButtons TIMING_BUTTONS;
 
-// handle passing of complex state between threads (everything else is a volatile uint, i think, but the Euclidean class is complex)
-// this stores three things:
-// - a set of values to create "the next" euclidean object while editing is in progress
-// - a "next" euclidean object created when editing last exited
-// - a "current" euclidean object that is used for sound generation
-// it is responsible for:
-// - creation of the "next" instance when editing finishes
-// - moving "next" to "current" when a new cycle begins (avoiding copy/assignment)
-// - holding the "current" instance in memory while it is in use
-// - avoiding access conflicts
-class EuclideanVault {
-private:
-  std::mutex access;
-  Euclidean euclideans[2];
-  bool updated = false;
-  uint current = 0;
-  uint next = 1;
-public:
-  uint voice;
-  uint n_places;
-  float frac_beats;
-  float frac_main;
-  uint prob;
-  EuclideanVault(uint n_places, float frac_beats, float frac_main, uint prob, uint voice)
-    : voice(voice), n_places(n_places), frac_beats(frac_beats), frac_main(frac_main), prob(prob) {
-    euclideans[0] = Euclidean(n_places, max(1u, static_cast<uint>(n_places * frac_beats)), frac_main, prob, voice);
-    euclideans[1] = Euclidean(n_places, max(1u, static_cast<uint>(n_places * frac_beats)), frac_main, prob, voice);
-  }
-  void apply_edit(bool dump) {
-    std::lock_guard<std::mutex> lock(access);
-    uint n_beats = max(1u, static_cast<uint>(n_places * frac_beats));
-    Euclidean candidate = Euclidean(n_places, n_beats, frac_main, prob, voice);
-    if (euclideans[updated ? next : current] != candidate) {
-      if (DBG_EUCLIDEAN) Serial.printf("Euclidean(%d, %d, %.3f, %d, %d)\n", n_places, n_beats, frac_main, prob, voice);
-      euclideans[next] = candidate;
-      updated = true;
-    }
-  };
-  Euclidean* get() {
-    std::unique_lock<std::mutex> lock(access, std::defer_lock);
-    if (lock.try_lock() && updated) {
-      std::swap(current, next);
-      updated = false;
-    }
-    return &euclideans[current];
-  }
-};
-
-static EuclideanVault VAULTS[2] = {EuclideanVault(16, 0.666, 0.5, 0, 0), EuclideanVault(25, 0.666, 0.5, 0x7fff, 2)};
-
 // edit patterns - hold down left or right two buttons (mask)
 class EuclideanButtons : public PotsReader {
 private:
@@ -1076,9 +484,9 @@ public:
       update_prime(&vault.frac_beats, vault.n_places, 1);
       update_lr(&vault.frac_main, 2, mask == 0x3u);
       update(&vault.prob, 3);
-      vault.apply_edit(false);
+      vault.apply_edit();
     } else if (editing) {
-      vault.apply_edit(true);
+      vault.apply_edit();
       disable();
       editing = false;
     }
@@ -1088,39 +496,6 @@ public:
 static EuclideanButtons EUCLIDEAN_BUTTONS_LEFT = EuclideanButtons(0x3, VAULTS[0]);
 static EuclideanButtons EUCLIDEAN_BUTTONS_RIGHT = EuclideanButtons(0xc, VAULTS[1]);
 
-// reverb via array of values (could maybe save space with int16, but store extra bits to reduce noise)
-template<int BITS> class Reverb {
-private:
-  static const uint max_size = 1 << BITS;
-  int tape[max_size];
-  uint write = 0;
-
-  class TapeEMA : public EMA<int> {
-  private:
-    Reverb<BITS>* reverb;
-  protected:
-    int get_state() {
-      return reverb->tape[reverb->write];
-    }
-    void set_state(int val) {
-      reverb->tape[reverb->write] = val;
-    }
-  public:
-    TapeEMA(Reverb<BITS>* reverb, uint bits, uint num, uint xtra) : EMA<int>(bits, num, xtra, 0), reverb(reverb) {};
-  };
-
-public:
-  uint size = max_size;
-  TapeEMA head;
-  Reverb() : head(TapeEMA(this, REVERB_DENOM_BITS, 1 << REVERB_DENOM_BITS, REVERB_EXTRA)) {};  // by default disabled
-  int next(int val) {
-    write = (write + 1) % max(1u, size);  // can't be "& mask" because size can vary
-    return head.next(val);
-  }
-};
-
-static Reverb REVERB = Reverb<13>();
-
 // post-process - outer two buttons
 class PostButtons : public PotsReader {
 private:
@@ -1131,8 +506,8 @@ public:
     if (STATE.button_mask == 0x9) {
       update(&REVERB.size, 0, -3, 0);
       update(&REVERB.head.num, 0, REVERB_DENOM_BITS - INTERNAL_BITS, 1);
-      update_frac(&COMP_BITS, 0, MAX_COMP_BITS, 2);
-      update(&DROP_BITS, 0, -12, 3);
+      update_frac(&AUDIO.comp_bits, 0, MAX_COMP_BITS, 2);
+      update(&AUDIO.drop_bits, 0, -12, 3);
     } else {
       disable();
     }
@@ -1155,6 +530,7 @@ public:
       update_signed(&VOICES[3].shift, 3);
     } else {
       ENABLED = enabled;
+      AUDIO.enabled = gray(ENABLED);
       disable();
     }
   }
@@ -1178,11 +554,11 @@ private:
     }
     current.reverb_size = REVERB.size;
     current.reverb_head_num = REVERB.head.num;
-    current.bpm = BPM;
-    current.patt_offset = PATT_OFFSET;
-    current.subdiv_idx = SUBDIV_IDX;
-    current.comp_bits = COMP_BITS;
-    current.drop_bits = DROP_BITS;
+    current.bpm = AUDIO.timing.bpm;
+    current.patt_offset = AUDIO.timing.patt_offset;
+    current.subdiv_idx = AUDIO.timing.subdiv_idx;
+    current.comp_bits = AUDIO.comp_bits;
+    current.drop_bits = AUDIO.drop_bits;
     current.local_buffer_size = LOCAL_BUFFER_SIZE;
     return current;
   }
@@ -1198,11 +574,11 @@ private:
     }
     REVERB.size = data.reverb_size;
     REVERB.head.num = data.reverb_head_num;
-    BPM = data.bpm;
-    PATT_OFFSET = data.patt_offset;
-    SUBDIV_IDX = data.subdiv_idx;
-    COMP_BITS = data.comp_bits;
-    DROP_BITS = data.drop_bits;
+    AUDIO.timing.bpm = data.bpm;
+    AUDIO.timing.patt_offset = data.patt_offset;
+    AUDIO.timing.subdiv_idx = data.subdiv_idx;
+    AUDIO.comp_bits = data.comp_bits;
+    AUDIO.drop_bits = data.drop_bits;
     LOCAL_BUFFER_SIZE = data.local_buffer_size;
   }
   bool exists(uint idx) {
@@ -1335,114 +711,9 @@ void IRAM_ATTR timer_callback(void*) {
   if (xHigherPriorityTaskWoken) portYIELD_FROM_ISR();
 }
 
-int compress(int out, uint bits, uint ceiling) {
-  int sign = sgn(out);
-  uint absolute = abs(out);
-  bits = min(bits, ceiling);
-  for (uint i = (ceiling - bits); i < ceiling; i++) {
-    uint limit = 1 << i;
-    if (absolute > limit) absolute = limit + ((absolute - limit) >> 1);
-    else break;
-  }
-  return sign * static_cast<int>(absolute);
-}
-
-int drop_bits(int amp) {
-  uint nv_bits = DROP_BITS;
-  if (nv_bits) {
-    int k = 1 << nv_bits;
-    return k * (amp / k);
-  } else {
-    return amp;
-  }
-}
-
-// apply post-processing
-uint post_process(int amp) {
-  // apply compressor
-  int soft_clipped = compress(amp, COMP_BITS, MAX_COMP_BITS);
-  // apply reverb
-  // int reverbed = soft_clipped;
-  int reverbed = REVERB.next(soft_clipped);
-  // apply quantisation
-  int shifted = drop_bits(reverbed);
-  // hard clip
-  int offset = shifted + 0x80;
-  int hard_clipped = max(0, min(0xff, offset));
-  if (DBG_VOLUME && !random(DBG_LOTTERY)) Serial.printf("amp %d; soft %d; revb %d; bits %d; off %d; hard %d\n", 
-                                                        amp, soft_clipped, reverbed, shifted, offset, hard_clipped);
-  return hard_clipped;
-}
-
-class Trigger {
-private:
-  EuclideanVault& vault;
-  Voice& voice;
-  bool major;
-  bool subdiv;
-  Euclidean* rhythm = nullptr;
-  enum Phase {Idle, Jiggle, Update};
-  Phase phase = Idle;
-  int offset = 0;
-  uint64_t trigger = 0;
-  void recalculate(int64_t ticks) {
-    rhythm = vault.get();
-    uint nv_interval = BEAT_SCALE / BPM;
-    if (subdiv) nv_interval = (nv_interval * SUBDIVS[SUBDIV_IDX]) / 60;
-    uint64_t beat = 1 + (ticks / nv_interval);
-    trigger = nv_interval * beat;
-    if (subdiv) {
-      offset = PATT_OFFSET * BEAT_SCALE / BPM;
-      int voice_offset = (voice.shift * static_cast<int>(nv_interval >> 4)) >> (INTERNAL_BITS - 5);  // spread bits to avoid overflow
-      offset += voice_offset;
-    }
-    // Serial.printf("reacalculate: voice %d major %d trigger %d\n", voice.idx, major, trigger);
-  }
-public:
-  Trigger(EuclideanVault& vault, Voice& voice, bool major, bool subdiv) : vault(vault), voice(voice), major(major), subdiv(subdiv) {
-    recalculate(0);
-  }
-  void on(int64_t ticks) {  // try to spread work across multiple ticks
-    ticks += offset;
-    if (phase == Idle && ticks > trigger) {
-      rhythm->on_beat(major);
-      phase = Jiggle;
-    } else if (phase == Jiggle) {
-      rhythm->jiggle();
-      phase = Update;
-    } else if (phase == Update) {
-      recalculate(ticks);
-      phase = Idle;
-    }
-  }
-};
-
-class Audio {
-private:
-  int64_t ticks = 0;
-  unsigned long start = 0;
-  Trigger triggers[4];
-public:
-  Audio(Trigger trigger1, Trigger trigger2, Trigger trigger3, Trigger trigger4) : triggers(trigger1, trigger2, trigger3, trigger4) {};
-  void generate(uint n, uint8_t data[]) {
-    for (uint i = 0; i < n; i++) {
-      uint j = ticks & 0x3;  // really subtle fix - we can get rhythms switching on the same beat if these don't match
-      triggers[j].on(ticks-j);
-      ticks++;
-      int vol = 0;
-      for (Voice& voice : VOICES) vol += voice.output();
-      data[i] = post_process(vol >> 2);  // avg
-    }
-  }
-};
-
 // run the ui on other core
 static TaskHandle_t ui_handle = NULL;
 
-static Audio AUDIO(Trigger(VAULTS[0], VOICES[0], true, false), 
-                   Trigger(VAULTS[0], VOICES[1], false, false), 
-                   Trigger(VAULTS[1], VOICES[2], true, true),
-                   Trigger(VAULTS[1], VOICES[3], false, true));
 static uint8_t BUFFER[2][MAX_LOCAL_BUFFER_SIZE];
 volatile static uint dma_idx = 0;  // not needed, afaict, because dma buffer is always large enough for what we have
 static SemaphoreHandle_t dma_semaphore;
@@ -1455,7 +726,7 @@ static dac_continuous_config_t dac_config = {
   .chan_mask = DAC_CHANNEL_MASK_CH0,
   .desc_num = 8,  // 2 allows pinpong for large buffers, but a larger value seems to help small buffers
   .buf_size = DMA_BUFFER_SIZE,
-  .freq_hz = SAMPLE_RATE_HZ,
+  .freq_hz = AUDIO.rate().sample_rate_hz,
   .offset = 0,
   .clk_src = DAC_DIGI_CLK_SRC_DEFAULT,
   .chan_mode = DAC_CHANNEL_MODE_SIMUL  // not used for single channel
@@ -1465,7 +736,7 @@ static dac_continuous_config_t dac_config = {
 class SysButtons : public PotsReader {
 private:
   uint buffer_frac = ((LOCAL_BUFFER_SIZE * (INTERNAL_MAX >> 1)) / MAX_LOCAL_BUFFER_SIZE) + (LOCAL_BUFFER_SIZE & 0x1 ? 0 : (INTERNAL_MAX >> 1));
-  uint oversample_bits = OVERSAMPLE_BITS;
+  uint oversample_bits = AUDIO.oversample_bits;
 public:
   SysButtons() = default;
   void read_state() {
@@ -1490,15 +761,10 @@ public:
       uint prev_oversample_bits = oversample_bits;
       update(&oversample_bits, 0, -14, 1);
       if (oversample_bits != prev_oversample_bits) {
-        OVERSAMPLE_BITS = oversample_bits;
-        BEAT_SCALE = (BASE_RATE_HZ << OVERSAMPLE_BITS) * 60;  // ticks for 1 bpm
-        SAMPLE_RATE_HZ = BASE_RATE_HZ << OVERSAMPLE_BITS;
-        TAU_BITS = INTERNAL_BITS + 1 + OVERSAMPLE_BITS;
-        TAU_N = 1 << TAU_BITS;
-        TAU_MAX = TAU_N - 1;
-        REFRESH_US = (1000000 * LOCAL_BUFFER_SIZE) / SAMPLE_RATE_HZ;
+        AUDIO.oversample_bits = oversample_bits;
+        REFRESH_US = (1000000 * LOCAL_BUFFER_SIZE) / AUDIO.rate().sample_rate_hz;
         stop_dac();
-        dac_config.freq_hz = SAMPLE_RATE_HZ;
+        dac_config.freq_hz = AUDIO.rate().sample_rate_hz;
         start_dac();
       }
     } else {
@@ -1522,6 +788,7 @@ void ui_loop(void*) {
     PERF_BUTTONS.read_state();                // left triplet
     SAVE_BUTTONS.read_state();                       // right triplet
     SYS_BUTTONS.read_state();                        // all
+    for (Voice& v : VOICES) STATE.voice(v.idx, v.active());  // leds follow voices
     if (count < 2 && DBG_STARTUP) Serial.printf("ui loop %d/2 on core %d\n", ++count, xPortGetCoreID());
     vTaskDelay(1);
   }
@@ -1546,7 +813,7 @@ void update_buffer() {
   static uint burst = 0;
   static EMA<uint> avg_duty = EMA<uint>(8, 1, 4, 100);
   unsigned long start = micros();
-  AUDIO.generate(LOCAL_BUFFER_SIZE, BUFFER[dma_idx]);
+  AUDIO.generate({BUFFER[dma_idx], LOCAL_BUFFER_SIZE});
   uint calc_time = micros() - start;
   uint duty = (100 * (dma_time + calc_time)) / REFRESH_US;
   if (duty > 100) dma_late += 1;
@@ -1556,7 +823,7 @@ void update_buffer() {
     Serial.println("---");
   }
   if (burst) {
-    Serial.printf("buffer %d; ov %d, dma %d, calc %d, duty %d/%d; errors %d, late %d\n", LOCAL_BUFFER_SIZE, OVERSAMPLE_BITS, dma_time, calc_time, duty, avg, dma_errors, dma_late);
+    Serial.printf("buffer %d; ov %d, dma %d, calc %d, duty %d/%d; errors %d, late %d\n", LOCAL_BUFFER_SIZE, AUDIO.oversample_bits, dma_time, calc_time, duty, avg, dma_errors, dma_late);
     burst--;
   }
   static uint startup_count = 0;
@@ -1602,8 +869,8 @@ void setup() {
   for (Button& b : VOICE_BUTTONS) b.init();
   if (DBG_STARTUP) Serial.printf("pots %d/4\n", POTS.size());
   for (Pot& p : POTS) p.init();
-  set_freq();
-  set_amp();
+  if (DBG_STARTUP) for (uint i = 0; i < FREQ_N; i++) Serial.printf("f %d %d\n", i, freq_table()[i]);
+  if (DBG_STARTUP) for (uint i = 0; i < AMP_N; i++) Serial.printf("a %d %d\n", i, amp_table()[i]);
   STATE.init();
 
   int ok = xTaskCreatePinnedToCore(&ui_loop, "UI Loop", 10000, NULL, 1, &ui_handle, 0);
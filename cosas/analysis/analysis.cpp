@@ -0,0 +1,126 @@
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <numbers>
+
+#include "cosas/constants.h"
+
+#include "analysis.h"
+
+
+void fft(std::vector<std::complex<double>>& x) {
+  const size_t n = x.size();
+  for (size_t i = 1, j = 0; i < n; i++) {
+    size_t bit = n >> 1;
+    for (; j & bit; bit >>= 1) j ^= bit;
+    j ^= bit;
+    if (i < j) std::swap(x[i], x[j]);
+  }
+  for (size_t len = 2; len <= n; len <<= 1) {
+    const std::complex<double> w = std::polar(1.0, -2 * std::numbers::pi / static_cast<double>(len));
+    for (size_t i = 0; i < n; i += len) {
+      std::complex<double> wk = 1;
+      for (size_t k = 0; k < len / 2; k++) {
+        const std::complex<double> a = x[i + k], b = x[i + k + len / 2] * wk;
+        x[i + k] = a + b;
+        x[i + k + len / 2] = a - b;
+        wk *= w;
+      }
+    }
+  }
+}
+
+// normalised so that a full scale sine has a total (summed over bins) of 0.5
+std::vector<double> power_spectrum(std::span<const int16_t> x) {
+  const size_t n = std::bit_floor(x.size());
+  std::vector<std::complex<double>> c(n);
+  double sum_w2 = 0;
+  for (size_t i = 0; i < n; i++) {
+    const double p = 2 * std::numbers::pi * static_cast<double>(i) / static_cast<double>(n);
+    const double w = 0.35875 - 0.48829 * cos(p) + 0.14128 * cos(2 * p) - 0.01168 * cos(3 * p);
+    sum_w2 += w * w;
+    c[i] = w * x[i] / static_cast<double>(SAMPLE_MAX);
+  }
+  fft(c);
+  std::vector<double> power(n / 2 + 1);
+  for (size_t k = 0; k <= n / 2; k++) {
+    power[k] = std::norm(c[k]) / (sum_w2 * static_cast<double>(n)) * (k && k < n / 2 ? 2 : 1);
+  }
+  return power;
+}
+
+static double db(const double ratio) {
+  return 10 * log10(std::max(ratio, 1e-30));
+}
+
+Analysis analyse(std::span<const int16_t> x, const float hz, std::span<const float> reference) {
+  static constexpr double LOBE = 4;  // blackman-harris main lobe half width (bins)
+  const std::vector<double> power = power_spectrum(x);
+  const size_t n = 2 * (power.size() - 1);
+  const double bin_hz = static_cast<double>(SAMPLE_RATE) / static_cast<double>(n);
+  const double h = static_cast<double>(hz) / bin_hz;  // fundamental in bins
+  double fundamental = 0, harmonics = 0, weighted = 0, total = 0;
+  std::vector<double> other;
+  double other_sum = 0;
+  for (size_t k = 0; k < power.size(); k++) {
+    weighted += power[k] * static_cast<double>(k) * bin_hz;
+    total += power[k];
+    if (k <= LOBE) continue;  // dc
+    const double m = std::round(static_cast<double>(k) / h);
+    if (m >= 1 && std::abs(static_cast<double>(k) - m * h) <= LOBE) {
+      (m == 1 ? fundamental : harmonics) += power[k];
+    } else {
+      other.push_back(power[k]);
+      other_sum += power[k];
+    }
+  }
+  double noise = 0;
+  if (!other.empty()) {
+    std::nth_element(other.begin(), other.begin() + static_cast<ptrdiff_t>(other.size() / 2), other.end());
+    noise = std::min(other_sum, other[other.size() / 2] * static_cast<double>(other.size()));
+  }
+  double snr = std::numeric_limits<double>::quiet_NaN();
+  if (!reference.empty()) {
+    double signal = 0, error = 0;
+    for (size_t i = 0; i < std::min(x.size(), reference.size()); i++) {
+      const auto r = static_cast<double>(reference[i]), e = x[i] - r;
+      signal += r * r;
+      error += e * e;
+    }
+    snr = error > 0 ? db(signal / error) : std::numeric_limits<double>::infinity();
+  }
+  return {fundamental, db(harmonics / fundamental), db((other_sum - noise) / fundamental),
+          db(noise / fundamental), snr, total > 0 ? weighted / total : 0};
+}
+
+
+// as BaseOscillator (without phase modulation)
+std::vector<int16_t> render(const Wavetable& table, const float hz, const size_t n) {
+  std::vector<int16_t> x(n);
+  const auto freq = static_cast<int32_t>(hz2freq(hz));
+  int32_t tick = 0;
+  for (int16_t& s : x) {
+    tick += freq;
+    if (tick > static_cast<int32_t>(FULL_TABLE_SUB)) tick -= static_cast<int32_t>(FULL_TABLE_SUB);
+    s = table.next(tick);
+  }
+  return x;
+}
+
+std::vector<int16_t> render(RelSource& source, const size_t n) {
+  std::vector<int16_t> x(n);
+  for (int16_t& s : x) s = source.next(0);
+  return x;
+}
+
+std::vector<float> reference(const std::function<double(double)>& shape, const float hz, const size_t n) {
+  std::vector<float> x(n);
+  const double f = freq2hz(hz2freq(hz));
+  for (size_t i = 0; i < n; i++) {
+    const double phase = f * static_cast<double>(i + 1) / SAMPLE_RATE;
+    x[i] = static_cast<float>(SAMPLE_MAX * shape(phase - std::floor(phase)));
+  }
+  return x;
+}
@@ -0,0 +1,58 @@
+
+#ifndef COSAS_ANALYSIS_H
+#define COSAS_ANALYSIS_H
+
+#include <complex>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+#include "cosas/source.h"
+#include "cosas/wavetable.h"
+
+
+// spectral measurements of rendered output (host only - this uses double
+// and the heap freely).  use from tests to put floors under the quality
+// of fast paths, eg
+//   const Analysis a = analyse(render(Sine(), 440), 440);
+//   CHECK(a.thd_db < -60);
+
+// in place radix 2 (size must be a power of 2)
+void fft(std::vector<std::complex<double>>& x);
+
+// blackman-harris (4 term) windowed power spectrum of the largest power
+// of 2 block from the start of x (bins 0 to n/2).
+std::vector<double> power_spectrum(std::span<const int16_t> x);
+
+
+// for a periodic signal with fundamental hz.  harmonics (including the
+// fundamental) are the bins within the window's main lobe of a multiple
+// of hz.  everything else (except dc) is split into noise (the median bin,
+// over all non-harmonic bins) and aliasing (the excess over that, so
+// discrete tones that are not harmonics).  dB values are relative to the
+// fundamental.  snr needs a reference (the ideal output, same scale) and
+// is measured in the time domain.
+
+struct Analysis {
+  double fundamental;  // power (per sample, in SAMPLE_MAX^2 units)
+  double thd_db;  // harmonics 2 and up
+  double alias_db;
+  double noise_db;
+  double snr_db;  // NaN without reference
+  double centroid;  // Hz (power weighted)
+};
+
+Analysis analyse(std::span<const int16_t> x, float hz, std::span<const float> reference = {});
+
+
+// rendering helpers.  the reference uses the oscillator's quantised
+// frequency so that phases match.
+
+std::vector<int16_t> render(const Wavetable& table, float hz, size_t n = 1 << 14);
+std::vector<int16_t> render(RelSource& source, size_t n = 1 << 14);
+// shape maps phase (0 to 1) to -1 to 1
+std::vector<float> reference(const std::function<double(double)>& shape, float hz, size_t n = 1 << 14);
+
+
+#endif
@@ -25,6 +25,9 @@ public:
   virtual uint8_t n_pages() = 0;
   virtual Param& get_param(uint8_t page, Knob knob) = 0;
   virtual TapMixin& get_tap(uint8_t page) = 0;
+  // if true, the previous source remains valid after get_source returns a
+  // new one (until the next call), so the two can be crossfaded.
+  virtual bool retains_sources() {return false;};
 
 };
 
@@ -4,7 +4,7 @@
 
 
 #include "cosas/app.h"
-#include "cosas/engine_small.h"
+#include "cosas/engine_cache.h"
 
 
 class FomeApp : public App {
@@ -15,10 +15,11 @@ public:
   RelSource* get_source(uint8_t s) override;
   uint8_t n_pages() override;
   Param& get_param(uint8_t page, Knob knob) override;
-  TapMixin& get_tap(uint8_t page) override;;
+  TapMixin& get_tap(uint8_t page) override;
+  bool retains_sources() override {return true;};
 
 private:
-  SmallManager manager;
+  EngineCache cache;
   uint8_t source_idx;
   RelSource* source = nullptr;
 };
@@ -0,0 +1,152 @@
+
+#ifndef COSAS_CONTROL_H
+#define COSAS_CONTROL_H
+
+
+#include <array>
+#include <cstdint>
+
+#include "cosas/constants.h"
+#include "cosas/params.h"
+#include "cosas/patomic.h"
+#include "cosas/node.h"
+
+
+// multi-rate graphs.  a node's rate_bits() says how many samples
+// (as a power of two) each call to next() covers.  control rate sources
+// declare CONTROL_BITS and transformers inherit the rate of their inputs,
+// so a whole modulation path (eg lfo -> gain) runs at control rate.
+// where it meets an audio rate consumer the manager inserts a Decimated,
+// which calls the subgraph once per block and interpolates (or holds).
+
+constexpr uint8_t CONTROL_BITS = 4;
+constexpr uint32_t CONTROL_N = 1 << CONTROL_BITS;
+
+
+class Decimated final : public RelSource {
+
+public:
+
+  Decimated(RelSource& src, bool hold);
+  [[nodiscard]] int16_t next(int32_t phi) override;
+
+private:
+
+  static constexpr uint8_t FRAC_BITS = 16;  // for interpolation
+  RelSource& src;
+  const uint8_t bits;
+  const uint32_t mask;
+  const bool hold;
+  uint32_t count = 0;
+  int32_t value = 0;  // FRAC_BITS fixed point
+  int32_t target = 0;  // value at end of block
+  int32_t step = 0;
+
+};
+
+
+// control rate (low frequency) sources for modulation.  each call advances
+// one block.  tables are tiny (the sine is 256 entries, shared) or shapes
+// are closed form, so these replace full oscillators (and their 44k poly
+// tables) for lfos and envelopes.
+
+// phase is 32 bits for a complete cycle.  phi is ignored (these are not
+// phase modulated).
+
+class ControlSource : public RelSource, public TapMixin {
+
+public:
+
+  class RateParam final : public Param {
+  public:
+    explicit RateParam(ControlSource* s);
+    void set(float hz) override;
+    float get() override;
+  private:
+    ControlSource* source;
+  };
+  friend class RateParam;
+
+  [[nodiscard]] int16_t next(int32_t phi) override;
+  [[nodiscard]] uint8_t rate_bits() const override {return CONTROL_BITS;};
+  RateParam& get_rate_param();
+
+protected:
+
+  explicit ControlSource(float hz);
+  [[nodiscard]] virtual int16_t at(uint32_t phase) const = 0;
+
+private:
+
+  static uint32_t hz2delta(float hz);
+  ATOMIC(uint32_t) delta;  // phase increment per block
+  uint32_t phase = 0;
+  RateParam rate_param;
+
+};
+
+
+// sine, triangle, saw (rising) and square.
+
+class Lfo final : public ControlSource {
+
+public:
+
+  enum Shape {SINE, TRIANGLE, SAW, SQUARE};
+  static constexpr size_t N_SHAPES = SQUARE + 1;
+
+  class ShapeParam final : public Param {
+  public:
+    explicit ShapeParam(Lfo* l);
+    void set(float v) override;
+    float get() override;
+  private:
+    Lfo* lfo;
+  };
+  friend class ShapeParam;
+
+  Lfo(float hz, Shape shape);
+  ShapeParam& get_shape_param();
+
+private:
+
+  static constexpr uint8_t SINE_BITS = 8;
+  static const std::array<int16_t, (1 << SINE_BITS) + 1>& sine_table();
+  [[nodiscard]] int16_t at(uint32_t phase) const override;
+  const std::array<int16_t, (1 << SINE_BITS) + 1>& sines;  // built in the constructor, not on the first sample
+  ATOMIC(uint8_t) shape;
+  ShapeParam shape_param;
+
+};
+
+
+// a repeating attack/decay envelope (linear segments, 0 to SAMPLE_MAX).
+// attack is the fraction of the cycle spent rising.
+
+class Envelope final : public ControlSource {
+
+public:
+
+  class AttackParam final : public Param {
+  public:
+    explicit AttackParam(Envelope* e);
+    void set(float v) override;
+    float get() override;
+  private:
+    Envelope* envelope;
+  };
+  friend class AttackParam;
+
+  Envelope(float hz, float attack);
+  AttackParam& get_attack_param();
+
+private:
+
+  [[nodiscard]] int16_t at(uint32_t phase) const override;
+  ATOMIC(uint32_t) attack;  // phase at peak
+  AttackParam attack_param;
+
+};
+
+
+#endif
@@ -0,0 +1,46 @@
+
+#ifndef COSAS_CROSSFADE_H
+#define COSAS_CROSSFADE_H
+
+
+#include <cstdint>
+
+#include "cosas/maths.h"
+#include "cosas/source.h"
+
+
+// the pair of sources handed from the ui to the audio callback.  while
+// fading, outgoing is rendered too (null is silence).
+
+struct SourcePair {
+  RelSource* incoming = nullptr;
+  RelSource* outgoing = nullptr;
+};
+
+
+// fixed-point linear crossfade from outgoing to incoming.  the weight
+// changes once per block, so the cost is a second next() and a multiply
+// per sample, for (1 << N_BLOCKS_BITS) blocks only.
+
+class Crossfade {
+
+public:
+
+  static constexpr uint32_t BLOCK_BITS = 5;  // 32 samples
+  static constexpr uint32_t N_BLOCKS_BITS = 6;  // 64 blocks, ~46ms at 44.1kHz
+  static constexpr uint32_t LENGTH = 1 << (BLOCK_BITS + N_BLOCKS_BITS);
+
+  void start();
+  [[nodiscard]] bool active() const;
+  int16_t mix(int16_t outgoing, int16_t incoming);  // advances one sample
+  int16_t next(const SourcePair& pair);  // uses mix if active
+
+private:
+
+  uint32_t count = LENGTH;  // samples since start
+  uint16_t weight = one14;  // of incoming, updated per block
+
+};
+
+
+#endif
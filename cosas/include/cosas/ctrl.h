@@ -3,6 +3,7 @@
 #define COSAS_CTRL_H
 
 #include "common.h"
+#include "patomic.h"
 
 #include <cstddef>
 #include <cstdint>
@@ -38,6 +39,7 @@ class CtrlEvent {
 class CtrlHandler {
 public:
   virtual void handle_ctrl_change(CtrlEvent /* event */) {};
+  virtual void handle_ctrl_tick() {};  // ctrl sampled, but no change
   virtual ~CtrlHandler() = default;
 };
 
@@ -62,12 +64,17 @@ public:  // TODO - event class
 // possible when flow resumes.  this is CRITICAL to getting a usable ui
 // with slow calculations.
 
+// coalesced counts knob events merged into an earlier event; dropped
+// counts knob events discarded because of a switch.
+
 class CtrlQueue {
 
 public:
   void add(CtrlEvent event);
   CtrlEvent pop();
   bool empty();
+  uint32_t coalesced = 0;
+  uint32_t dropped = 0;
 
 private:
   bool empty_ = true;
@@ -77,5 +84,45 @@ private:
 };
 
 
+// a single-producer, single-consumer ring of packed ctrl events in memory
+// shared between the cores.  the producer (audio isr on core 0) calls
+// push(); the consumer (ui on core 1) calls pop().
+
+// the consumer takes everything available from the ring in one batch and
+// adds it to a CtrlQueue, so knob movement that arrived while the ui was
+// stalled is coalesced there (as above) before it is handled.
+
+// if the ring is full the producer coalesces into its own CtrlQueue, which
+// is flushed to the ring on the next push, or by flush() (called on every
+// ctrl tick, so the last spilled event arrives even if nothing else moves).
+
+// push() and flush() return true only when the consumer had caught up (ie
+// may be waiting), so the producer needs to wake the consumer only then.
+
+class CtrlRing {
+
+public:
+  static constexpr size_t SIZE_BITS = 5;
+  static constexpr uint32_t SIZE = 1 << SIZE_BITS;
+  static constexpr uint32_t MASK = SIZE - 1;
+  CtrlRing();
+  bool push(CtrlEvent event);
+  bool flush();
+  bool pop(CtrlEvent& event);
+  [[nodiscard]] uint32_t get_drops() const;
+  [[nodiscard]] uint32_t get_coalesces() const;
+
+private:
+  bool publish(CtrlEvent* event);
+  void drain();
+  uint32_t ring[SIZE] = {};
+  ATOMIC(uint32_t) head;  // written only by producer
+  ATOMIC(uint32_t) tail;  // written only by consumer
+  CtrlQueue overflow;  // producer only
+  CtrlQueue pending;  // consumer only
+
+};
+
+
 #endif
 
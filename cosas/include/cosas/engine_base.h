@@ -3,9 +3,12 @@
 #define COSAS_ENGINE_BASE_H
 
 #include <tuple>
+#include <type_traits>
 #include <vector>
 #include <memory>
 
+#include "cosas/control.h"
+#include "cosas/modulators.h"
 #include "cosas/oscillator_old.h"
 #include "cosas/pane.h"
 #include "cosas/params.h"
@@ -14,6 +17,19 @@
 
 // UNUSED - may be broken
 
+
+// evaluation counts for the current graph (see Shared and BaseOscillator).
+// repeats are oscillator reads after the first in a frame (phase modulated
+// reads of a shared oscillator); before the clock these also advanced time.
+
+struct EvalStats {
+  uint32_t frames = 0;
+  uint32_t evals = 0;
+  uint32_t repeats = 0;
+  uint32_t shared_hits = 0;
+};
+
+
 class BaseManager {
 
 public:
@@ -21,12 +37,18 @@ public:
   BaseManager();
   [[nodiscard]] Pane& get_pane(size_t n) const;
   [[nodiscard]] size_t n_panes() const;
+  // approximate heap used by the current graph (poly tables dominate)
+  [[nodiscard]] size_t get_footprint() const;
+  [[nodiscard]] EvalStats get_eval_stats() const;
 
 protected:
 
   template <typename SourceType, typename... Args>
   SourceType& add_source(Args&&... args) {
     std::unique_ptr<SourceType> source = std::make_unique<SourceType>(std::forward<Args>(args)...);
+    footprint += sizeof(SourceType);
+    if constexpr (std::is_base_of_v<PolyMixin, SourceType>) footprint += sizeof(PolyTable);
+    if constexpr (std::is_base_of_v<BaseOscillator, SourceType>) source->set_clock(&clock);
     current_sources->push_back(std::move(source));
     return dynamic_cast<SourceType&>(*current_sources->back());
   }
@@ -34,11 +56,15 @@ protected:
   template <typename ParamType, typename... Args>
   ParamType& add_param(Args&&... args) {
     std::unique_ptr<ParamType> input = std::make_unique<ParamType>(std::forward<Args>(args)...);
+    footprint += sizeof(ParamType);
     current_params->push_back(std::move(input));
     return dynamic_cast<ParamType&>(*current_params->back());
   }
 
   void clear_all();
+  RelSource& add_frame(RelSource& root);
+  RelSource& add_shared(RelSource& src);
+  RelSource& at_audio_rate(RelSource& src, bool hold = false);
   Pane& add_pane(Param& main, Param& x, Param& y) const;
   Pane& add_pane(Param& main, Param& x, Param& y, TapMixin& tap) const;
   void swap_panes(size_t i, size_t j) const;
@@ -47,7 +73,10 @@ protected:
   std::tuple<Gain&, AbsPolyOsc&> add_abs_poly_osc_w_gain(float frq, size_t shp, size_t asym, size_t off, float amp);
   RelPolyOsc& add_rel_poly_osc(AbsFreqParam& frq, size_t shp, size_t asym, size_t off);
   std::tuple<Gain&, RelPolyOsc&> add_rel_poly_osc_w_gain(AbsFreqParam& frq, size_t shp, size_t asym, size_t off, float amp);
+  std::tuple<Gain&, Lfo&> add_lfo_w_gain(float hz, Lfo::Shape shape, float amp);
+  Envelope& add_envelope(float hz, float attack);
   Merge& add_balance(RelSource& a, RelSource& b, float bal);
+  AM& add_am(RelSource& a, RelSource& b);
   Mix& add_fm(RelSource& c, RelSource& m, float bal);
   RelSource& add_fm(RelSource& c,  RelSource& m, float bal, float amp);
   RelSource& add_fm(RelSource& c,  RelSource& m, float bal, float amp, Param& right);
@@ -57,6 +86,8 @@ private:
   std::unique_ptr<std::vector<std::unique_ptr<RelSource>>> current_sources;
   std::unique_ptr<std::vector<std::unique_ptr<Param>>> current_params;
   std::unique_ptr<std::vector<std::unique_ptr<Pane>>> current_panes;
+  size_t footprint = 0;
+  Clock clock;
 };
 
 
@@ -0,0 +1,56 @@
+
+#ifndef COSAS_ENGINE_CACHE_H
+#define COSAS_ENGINE_CACHE_H
+
+
+#include <array>
+#include <memory>
+
+#include "cosas/engine_small.h"
+
+
+// keep recently used engines built (with their parameter state) so that
+// switching between them is just a pointer swap.  each engine has its own
+// manager.  when the total footprint exceeds the budget, the least recently
+// used engines are discarded.  the active engine and the one it replaced
+// are never discarded, even if over budget (so the old engine can still be
+// rendered while fading out).
+
+class EngineCache {
+
+public:
+
+  // enough for all the current small engines (poly tables are ~44k each)
+  static constexpr size_t DEFAULT_BUDGET = 144 * 1024;
+
+  explicit EngineCache(size_t budget = DEFAULT_BUDGET);
+  RelSource& select(SmallManager::SmallEngine engine);
+  [[nodiscard]] SmallManager& get_manager() const;
+  [[nodiscard]] bool is_built(SmallManager::SmallEngine engine) const;
+  [[nodiscard]] size_t n_built() const;
+  [[nodiscard]] size_t get_used() const;
+  [[nodiscard]] uint32_t get_builds() const;
+
+private:
+
+  struct Entry {
+    std::unique_ptr<SmallManager> manager;
+    RelSource* source = nullptr;
+    size_t bytes = 0;  // zero until first built
+    uint32_t stamp = 0;
+  };
+
+  bool evict_lru(size_t keep, size_t prev);
+  void discard(Entry& entry);
+
+  size_t budget;
+  size_t used = 0;
+  uint32_t clock = 0;
+  uint32_t builds = 0;
+  size_t active = SmallManager::N_ENGINE;
+  std::array<Entry, SmallManager::N_ENGINE> entries;
+
+};
+
+
+#endif
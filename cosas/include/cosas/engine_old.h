@@ -8,6 +8,7 @@
 
 #include "cosas/engine_base.h"
 #include "cosas/oscillator_old.h"
+#include "cosas/oscillator_new.h"
 #include "cosas/params.h"
 #include "cosas/wavelib.h"
 
@@ -38,7 +39,9 @@ private:
   std::tuple<AbsFreqParam&, RelSource&> add_abs_dex_osc(float frq, size_t widx);
   std::tuple<AbsFreqParam&, RelSource&> add_abs_dex_osc_w_gain(float frq, size_t widx, float amp);
   RelSource& add_rel_dex_osc(AbsFreqParam& root, size_t widx, float r, float d);
+  FbDexOsc& add_fb_dex_osc(AbsFreqParam& root, size_t widx, float r, float d, float fb);
 
+  RelSource& build_engine(OldEngine engine);
   RelSource& build_dex();
   RelSource& build_poly();
   RelSource& build_fm_simple();
@@ -3,7 +3,10 @@
 #define COSAS_ENGINE_SMALL_H
 
 
+#include <span>
+
 #include "cosas/engine_base.h"
+#include "cosas/operators.h"
 
 
 
@@ -13,17 +16,23 @@ public:
 
   enum SmallEngine {
     OSCILLATOR,
-    SIMPLE_2_OSC_FM
+    SIMPLE_2_OSC_FM,
+    FM_4_OP,
+    FM_6_OP
   };
-  static constexpr size_t N_ENGINE = SIMPLE_2_OSC_FM + 1;
+  static constexpr size_t N_ENGINE = FM_6_OP + 1;
 
   SmallManager() = default;
   RelSource& build(SmallEngine);
 
 private:
 
+  RelSource& build_engine(SmallEngine engine);
   RelSource& build_oscillator();
   RelSource& build_simple_2_osc_fm();
+  RelSource& build_fm_4_op();
+  RelSource& build_fm_6_op();
+  RelSource& add_operators(size_t n, size_t alg, std::span<const float> ratios, std::span<const float> levels);
 
 };
 
@@ -2,6 +2,7 @@
 #ifndef WEAS_FILTER_H
 #define WEAS_FILTER_H
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <array>
@@ -117,5 +118,103 @@ private:
 
 };
 
-#endif
 
+// decimators for oversampled adc data (see Codec).  next() takes a block of
+// (1 << RATE_BITS) 12 bit samples, every stride'th value from in, and
+// returns a single 12 bit value.  state is kept between blocks.  with
+// RATE_BITS of 0 they pass values through.
+
+// a CIC (sinc^ORDER) filter.  no multiplies and wrapping arithmetic is
+// harmless, so the gain ((1 << RATE_BITS)^ORDER) is simply shifted away.
+// nulls fall on multiples of the output rate (where aliases fold to dc),
+// but the passband droops (-3.9dB at the output nyquist for order 3).
+
+template<size_t ORDER, size_t RATE_BITS> class Cic {
+
+public:
+
+  uint16_t next(const uint16_t* in, size_t stride) {
+    for (size_t i = 0; i < N; i++) {
+      uint32_t x = in[i * stride];
+      for (size_t k = 0; k < ORDER; k++) x = integrator[k] += x;
+    }
+    uint32_t y = integrator[ORDER - 1];
+    for (size_t k = 0; k < ORDER; k++) {
+      const uint32_t prev = comb[k];
+      comb[k] = y;
+      y -= prev;
+    }
+    return static_cast<uint16_t>(y >> (ORDER * RATE_BITS));
+  };
+
+private:
+  static_assert(12 + ORDER * RATE_BITS <= 32);
+  static constexpr size_t N = 1 << RATE_BITS;
+  std::array<uint32_t, ORDER> integrator = {};
+  std::array<uint32_t, ORDER> comb = {};
+
+};
+
+
+// a cascade of half-band FIR stages, each decimating by 2.  the taps
+// (3, 0, -25, 0, 150, 256, 150, 0, -25, 0, 3) / 512 need 4 multiplies per
+// output (symmetry and zeros).  flatter than the CIC in the passband but
+// only -6dB at the output nyquist (as for any half-band).
+
+template<size_t RATE_BITS> class HalfBand {
+
+public:
+
+  uint16_t next(const uint16_t* in, size_t stride) {
+    int32_t out = 0;
+    for (size_t i = 0; i < (1u << RATE_BITS); i++) push(0, in[i * stride] << EXTRA, out);
+    return static_cast<uint16_t>(std::max(0, std::min(4095, (out + (1 << (EXTRA - 1))) >> EXTRA)));
+  };
+
+private:
+  static constexpr size_t EXTRA = 4;
+  static constexpr size_t LEN = 16;  // power of 2 >= 11 taps
+  static constexpr size_t MASK = LEN - 1;
+  std::array<std::array<int32_t, LEN>, RATE_BITS + 1> history = {};
+  std::array<size_t, RATE_BITS + 1> index = {};
+
+  void push(size_t stage, int32_t x, int32_t& out) {
+    if (stage == RATE_BITS) {
+      out = x;
+      return;
+    }
+    std::array<int32_t, LEN>& h = history[stage];
+    const size_t i = index[stage]++;
+    h[i & MASK] = x;
+    if (i & 1) {
+      const int32_t y = (256 * h[(i - 5) & MASK] + 150 * (h[(i - 4) & MASK] + h[(i - 6) & MASK])
+                         - 25 * (h[(i - 2) & MASK] + h[(i - 8) & MASK]) + 3 * (h[i & MASK] + h[(i - 10) & MASK])) >> 9;
+      push(stage + 1, y, out);
+    }
+  };
+
+};
+
+
+// a one pole low pass for 12 bit values, keeping EXTRA fractional bits.
+// alpha is NUM / (1 << SHIFT) and the cutoff is ~ fs alpha / (2 pi (1 - alpha)).
+// one multiply (by a small constant) per sample.
+
+template<int32_t NUM, size_t SHIFT, size_t EXTRA> class OnePole {
+
+public:
+
+  uint16_t next(uint16_t in) {
+    state += ((static_cast<int32_t>(in << EXTRA) - state) * NUM) >> SHIFT;
+    return static_cast<uint16_t>(state >> EXTRA);
+  };
+
+  void reset(uint16_t in) {state = in << EXTRA;};
+
+private:
+  int32_t state = 0;
+
+};
+
+
+#endif
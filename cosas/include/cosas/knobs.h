@@ -1,13 +1,19 @@
-
 #ifndef COSAS_KNOBS_H
 #define COSAS_KNOBS_H
 
+#include <array>
+#include <cstdint>
+
 #include "cosas/params.h"
 
 
 // these are NOT intended for use in cosas code; they're here only because
 // i wanted to test them.  see param.h for the cosas "side".
 
+// knob positions are fixed point (POSITION_BITS) so that handling an event
+// (on the ui core, before the change reaches the audio) needs no float maths
+// until the final value is passed to the param.
+
 
 class KnobHandler;
 
@@ -20,8 +26,9 @@ class KnobChange {
 
 public:
   enum Highlight {No, Near, Yes};
-  KnobChange(KnobHandler *k, float n, Highlight h) : normalized(n), highlight(h), knob(k) {};
+  KnobChange(KnobHandler *k, uint16_t p, Highlight h);
   ~KnobChange();
+  uint16_t position;  // POSITION_BITS fixed point
   float normalized;
   Highlight highlight;
 
@@ -33,28 +40,32 @@ private:
 class KnobHandler {
 
 public:
+  static constexpr uint8_t POSITION_BITS = 16;
+  static constexpr int32_t ONE = 1 << POSITION_BITS;
   friend class KnobChange;
-  KnobHandler(float s, float ln, bool lg, float lo, float hi)
-  : scale(s), linearity(ln), log(lg), lo(lo), hi(hi) {};
+  KnobHandler(float s, float ln, bool lg, float lo, float hi);
   KnobHandler() : valid(false) {};
   KnobChange handle_knob_change(uint16_t now, uint16_t prev);
   virtual ~KnobHandler() = default;
   bool is_valid();
 
 protected:
+  static constexpr uint8_t COEFF_BITS = 12;
   bool valid = true;
   // processing on input
-  float normalized = 0.5;
-  float scale = 1;
-  float linearity = 1;  // 0 flat, 1 linear
+  int32_t position = ONE / 2;  // [0, ONE)
+  int32_t scale = 1 << COEFF_BITS;  // COEFF_BITS fixed point
+  int32_t cubic = 0;  // 4 * (1 - linearity)
+  int32_t linear = 1 << COEFF_BITS;  // linearity
   // processing on output
   bool log = false;
   float lo = 0;
   float hi = 1;
   virtual void apply_change() {};
   KnobChange::Highlight ends();
-  float clip(float n);
-  float sigmoid(uint16_t now, uint16_t prev);
+  static int32_t clip(int32_t p);
+  [[nodiscard]] int32_t response(uint16_t adc) const;
+  int32_t sigmoid(uint16_t now, uint16_t prev);
 };
 
 
@@ -65,10 +76,14 @@ public:
   void apply_change() override;
 
 private:
+  static constexpr uint8_t EXP_BITS = 8;
+  using ExpTable = std::array<uint32_t, (1 << EXP_BITS) + 1>;
+  static const ExpTable& exp2_table();
   Param& param;
+  float base = 1;  // 10^lo, if log
+  int32_t octaves = 0;  // (hi - lo) * log2(10), POSITION_BITS fixed point, if log
 
 };
 
 
 #endif
-
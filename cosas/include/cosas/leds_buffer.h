@@ -5,18 +5,28 @@
 
 #include "cosas/leds_mask.h"
 
+#include <array>
+#include <atomic>
 #include <memory>
-#include <queue>
 
 
+// queue() is called from the ui loop and render() from a timer (which may
+// be on another core).  they share a fixed ring of transitions (single
+// producer, single consumer, so only atomic loads and stores are needed).
+// each transition is (from, to, steps) and the frames are calculated as
+// they are shown, so queueing is O(1) and never allocates.
+
 class BaseLEDsBuffer {
 
 public:
   static constexpr size_t INTERP_BITS = 2;
   static constexpr size_t INTERP_N = 1 << INTERP_BITS;
+  static constexpr size_t CAPACITY_BITS = 5;
+  static constexpr size_t CAPACITY = 1 << CAPACITY_BITS;
   static BaseLEDsBuffer& get();
   // TODO - not clear we need force (since n=0 does the same)
-  void queue(uint32_t mask, bool force, bool interp, size_t n);
+  // returns false (and drops the transition) if the ring is full
+  bool queue(uint32_t mask, bool force, bool interp, size_t n);
   uint32_t get_mask();
   const std::unique_ptr<BaseLEDsMask> leds_mask;
 
@@ -27,8 +37,23 @@ protected:
   void render();
 
 private:
-  uint32_t mask = 0;
-  std::queue<std::tuple<uint32_t, bool>> buffer;
+  // frames 0..steps-1 are shown one per render (interpolated first, then
+  // held at to).  frame steps is to and does not wait.
+  struct Transition {
+    uint32_t from;
+    uint32_t to;
+    uint16_t steps;
+    bool interp;
+  };
+  [[nodiscard]] uint32_t frame(const Transition& t, size_t step) const;
+  std::array<Transition, CAPACITY> ring{};
+  // counts (not indices) so that full and empty differ.  written by one side only.
+  std::atomic<uint32_t> written = 0;
+  std::atomic<uint32_t> read = 0;
+  std::atomic<uint32_t> skip_to = 0;  // set by force (read may jump forwards to here)
+  std::atomic<uint32_t> mask = 0;
+  uint32_t last = 0;  // producer's copy of the final mask queued
+  size_t step = 0;  // consumer's position in the current transition
 };
 
 
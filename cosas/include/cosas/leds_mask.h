@@ -14,13 +14,18 @@ class BaseLEDsMask {
 
 public:
   static constexpr size_t N = 6;
+  static constexpr uint8_t RING_BITS = 12;  // resolution of ring position
   explicit BaseLEDsMask(uint8_t bits);
   virtual ~BaseLEDsMask() = default;
   uint32_t reverse(uint32_t mask);
   uint32_t vinterp(size_t off, uint32_t a, uint32_t b);
   uint32_t hinterp(size_t off, uint32_t a, uint32_t b);
   uint32_t constant(uint8_t fg);
+  // ring is quantised to RING_BITS and uses ring_fixed (no float maths per led).
+  // ring_float is the original (identical on the RING_BITS grid).
   uint32_t ring(float normalized, bool highlight);
+  uint32_t ring_fixed(uint16_t position, bool highlight);
+  uint32_t ring_float(float normalized, bool highlight);
   uint32_t square(bool bottom, uint8_t amplitude);
   uint32_t vbar(bool right, uint8_t amplitude);
   uint32_t rot2dot(size_t off, uint8_t fg, uint8_t bg);
@@ -35,6 +40,8 @@ private:
   const uint32_t SIDE_MASK;
   const size_t ring_order[N] = {4, 2, 0, 1, 3, 5};
   uint32_t overwrite(uint32_t mask, float centre, float width, uint8_t amplitude);
+  uint32_t overwrite_fixed(uint32_t mask, int32_t centre, int32_t half_width, uint8_t amplitude);
+  uint32_t update(uint32_t mask, size_t led, uint8_t new_val);
   const uint8_t wiggle[19] = {
     0b010101, 0b010100, 0b011100, 0b011000, 0b111000, 0b110000, 0b110100,
     0b100100, 0b101100, 0b001100, 0b001101, 0b001001, 0b001011, 0b000011,
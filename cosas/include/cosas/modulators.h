@@ -10,10 +10,14 @@
 class Modulator : public RelSource {};
 
 
+// rate is the fastest input
+
+
 class FM : public Modulator {
 public:
   FM(RelSource& car, RelSource& mod);
   [[nodiscard]] int16_t next(int32_t phi) override;
+  [[nodiscard]] uint8_t rate_bits() const override;
 private:
   RelSource& carrier;
   RelSource& modulator;
@@ -25,6 +29,7 @@ public:
   // note that this is not symmetric - nd1 is mixed against the ring mod output
   AM(RelSource& src1, RelSource& src2);
   [[nodiscard]] int16_t next(int32_t phi) override;
+  [[nodiscard]] uint8_t rate_bits() const override;
 private:
   RelSource& src1;
   RelSource& src2;
@@ -73,6 +73,59 @@ private:
 };
 
 
+// a frame (sample) counter shared by the nodes in a graph.  the Frame at
+// the root advances it once per sample so that nodes with several
+// consumers can tell whether they have already been evaluated.
+
+class Clock {
+public:
+  void advance() {frame++;};
+  [[nodiscard]] uint32_t get() const {return frame;};
+private:
+  uint32_t frame = 0;
+};
+
+
+// evaluate-once wrapper for a node with several consumers.  the value is
+// cached per frame and phi (phase modulated reads genuinely differ, so
+// they are evaluated again).
+
+class Shared final : public RelSource {
+
+public:
+
+  Shared(RelSource& src, Clock& clock);
+  [[nodiscard]] int16_t next(int32_t phi) override;
+  [[nodiscard]] uint8_t rate_bits() const override {return src.rate_bits();};
+  [[nodiscard]] uint32_t get_hits() const;
+
+private:
+
+  RelSource& src;
+  Clock& clock;
+  uint32_t stamp;
+  int32_t cached_phi = 0;
+  int16_t cached = 0;
+  uint32_t hits = 0;
+};
+
+
+// the root of a graph (advances the clock before evaluating).
+
+class Frame final : public RelSource {
+
+public:
+
+  Frame(RelSource& src, Clock& clock);
+  [[nodiscard]] int16_t next(int32_t phi) override;
+
+private:
+
+  RelSource& src;
+  Clock& clock;
+};
+
+
 class TapMixin {
 public:
   TapMixin() {};
@@ -0,0 +1,55 @@
+
+#ifndef COSAS_NOISE_H
+#define COSAS_NOISE_H
+
+
+#include <cstdint>
+
+#include "cosas/constants.h"
+#include "cosas/params.h"
+#include "cosas/patomic.h"
+#include "cosas/node.h"
+#include "cosas/random.h"
+
+
+// noise generated as needed (unlike the Noise wavetable, which holds a
+// second of samples, needs a 176k float temporary to smooth, and loops).
+// white noise from XorShift32 is smoothed by a one pole low pass
+// filter, y += (x - y) >> smooth, so smooth 0 is white and each step
+// roughly halves the cutoff.  smoothed noise is rescaled to an rms of
+// SAMPLE_MAX / 3 (white is uniform, with an rms of SAMPLE_MAX / sqrt 3).
+
+class NoiseSource final : public RelSource, public TapMixin {
+
+public:
+
+  class SmoothParam final : public Param {
+  public:
+    explicit SmoothParam(NoiseSource* n);
+    void set(float v) override;
+    float get() override;
+  private:
+    NoiseSource* noise;
+  };
+  friend class SmoothParam;
+
+  static constexpr uint8_t MAX_SMOOTH = 8;
+
+  explicit NoiseSource(uint8_t smooth, uint32_t seed = 1);  // fixed seed so output is repeatable
+  [[nodiscard]] int16_t next(int32_t phi) override;
+  SmoothParam& get_smooth_param();
+
+private:
+
+  static constexpr uint8_t FRAC_BITS = 16;  // filter state
+  static constexpr uint8_t GAIN_BITS = 8;
+  XorShift32 random;
+  ATOMIC(uint8_t) smooth;
+  ATOMIC(int32_t) gain;  // GAIN_BITS fixed point
+  int32_t state = 0;  // FRAC_BITS fixed point
+  SmoothParam smooth_param;
+
+};
+
+
+#endif
@@ -0,0 +1,142 @@
+
+#ifndef COSAS_OPERATORS_H
+#define COSAS_OPERATORS_H
+
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "cosas/constants.h"
+#include "cosas/node.h"
+#include "cosas/params.h"
+#include "cosas/patomic.h"
+#include "cosas/source.h"
+
+
+// a dx-style fm voice with 4-6 sine operators in a single node.  the
+// engines in engine_old.cpp wire oscillators with FM/Mix/Merge nodes,
+// which costs a virtual call (and a 44k poly table or a shared wavedex
+// lookup) per oscillator per sample.  here operator state is held as
+// arrays (phase, increment, level, feedback) and all operators are
+// evaluated in one loop, so many more operators fit in the same budget.
+
+// routing comes from a table of algorithms.  operator 0 is always a
+// carrier and operators are evaluated from the highest index down, so an
+// operator can only be modulated by operators with a higher index.
+
+// phase is 32 bits for a complete cycle.  the sine is a small (1k) table,
+// linearly interpolated, shared by all instances.
+
+class Operators final : public RelSource, public TapMixin {
+
+public:
+
+  static constexpr size_t MAX_OPS = 6;
+
+  struct Algorithm {
+    std::array<uint8_t, MAX_OPS> mods;  // bitmask of modulators, per operator
+    uint8_t carriers;  // bitmask of operators summed to output
+  };
+
+  static constexpr size_t N_ALGORITHMS = 8;
+  static const std::array<Algorithm, N_ALGORITHMS> ALGORITHMS_4;
+  static const std::array<Algorithm, N_ALGORITHMS> ALGORITHMS_6;
+
+  class FreqParam final : public Param {
+  public:
+    explicit FreqParam(Operators* o);
+    void set(float hz) override;
+    float get() override;
+  private:
+    Operators* ops;
+  };
+
+  class AlgorithmParam final : public Param {
+  public:
+    explicit AlgorithmParam(Operators* o);
+    void set(float v) override;
+    float get() override;
+  private:
+    Operators* ops;
+  };
+
+  // per-operator params know their index
+  class OpParam : public Param {
+  public:
+    OpParam(Operators* o, size_t i, float scale, float linearity, bool log, float lo, float hi);
+  protected:
+    Operators* ops;
+    size_t idx;
+  };
+
+  class RatioParam final : public OpParam {
+  public:
+    RatioParam(Operators* o, size_t i);
+    void set(float v) override;
+    float get() override;
+  };
+
+  class LevelParam final : public OpParam {
+  public:
+    LevelParam(Operators* o, size_t i);
+    void set(float v) override;
+    float get() override;
+  };
+
+  class FeedbackParam final : public OpParam {
+  public:
+    FeedbackParam(Operators* o, size_t i);
+    void set(float v) override;
+    float get() override;
+  };
+
+  friend class FreqParam;
+  friend class AlgorithmParam;
+  friend class RatioParam;
+  friend class LevelParam;
+  friend class FeedbackParam;
+
+  // ratios and levels are for operators 0..n-1.  feedback is on the top operator.
+  Operators(size_t n, float hz, size_t alg, std::span<const float> ratios, std::span<const float> levels, float fb);
+  [[nodiscard]] int16_t next(int32_t phi) override;
+  [[nodiscard]] size_t n_ops() const;
+  FreqParam& get_freq_param();
+  AlgorithmParam& get_alg_param();
+  RatioParam& get_ratio_param(size_t i);
+  LevelParam& get_level_param(size_t i);
+  FeedbackParam& get_fb_param(size_t i);
+
+private:
+
+  static constexpr uint8_t SINE_BITS = 10;
+  static constexpr uint8_t ONE_BITS = 16;  // fixed point for level and feedback
+  static constexpr uint8_t MOD_BITS = 21;  // full level modulator swings +/- ~1 cycle
+  static constexpr uint8_t FB_BITS = 19;  // full feedback swings +/- ~1/4 cycle
+  using Table = std::array<int16_t, (1 << SINE_BITS) + 1>;
+  static const Table& sine_table();
+  [[nodiscard]] static int16_t sine(const Table& t, uint32_t phase);
+  void recalculate(size_t i);
+  const size_t n;
+  const std::span<const Algorithm> algorithms;
+  const Table& sines;  // built in the constructor, not on the first sample
+  ATOMIC(uint8_t) algorithm;
+  ATOMIC(uint32_t) root;  // phase increment for ratio 1
+  // structure of arrays
+  std::array<uint32_t, MAX_OPS> phase{};
+  std::array<ATOMIC(uint32_t), MAX_OPS> delta;
+  std::array<ATOMIC(int32_t), MAX_OPS> level;  // ONE_BITS fixed point
+  std::array<ATOMIC(int32_t), MAX_OPS> feedback;  // ONE_BITS fixed point
+  std::array<float, MAX_OPS> ratio{};
+  std::array<int16_t, MAX_OPS> out{};  // current sample (after level)
+  std::array<int16_t, MAX_OPS> prev{};  // previous sample (for feedback)
+  FreqParam freq_param;
+  AlgorithmParam alg_param;
+  std::array<RatioParam, MAX_OPS> ratio_params;
+  std::array<LevelParam, MAX_OPS> level_params;
+  std::array<FeedbackParam, MAX_OPS> fb_params;
+
+};
+
+
+#endif
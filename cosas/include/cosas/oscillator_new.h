@@ -10,6 +10,115 @@
 #include "cosas/params.h"
 #include "cosas/wavelib.h"
 #include "cosas/node.h"
+#include "cosas/oscillator_old.h"
+
+
+// a dx-style operator: a relative wavedex oscillator with self feedback.
+// the average of the last two outputs (which damps the "hunting" of
+// single sample feedback) is scaled by the fb param and added to phi, so
+// feedback uses the same phase scaling as FM.  at full fb the gain is that
+// used by the old FM_FB loop (1 / (1 << (PHI_FUDGE_BITS - 4))).
+
+class FbDexOsc final : public BaseOscillator, public WavedexMixin {
+public:
+  class FeedbackParam final : public Param {
+  public:
+    explicit FeedbackParam(FbDexOsc* o);
+    void set(float v) override;
+    float get() override;
+  private:
+    FbDexOsc* oscillator;
+  };
+  friend class FeedbackParam;
+  FbDexOsc(Wavelib& wl, size_t widx, AbsFreqParam& root, float f, float d, float fb);
+  [[nodiscard]] int16_t next(int32_t phi) override;
+  RelFreqParam& get_freq_param();
+  FeedbackParam& get_fb_param();
+private:
+  static constexpr uint8_t FB_BITS = 16 + PHI_FUDGE_BITS - 4;
+  RelFreqParam freq_param;
+  ATOMIC(int32_t) feedback;  // FB_BITS fixed point
+  FeedbackParam fb_param;
+  int16_t y1 = 0;
+  int16_t y2 = 0;
+};
+
+
+// band limited square and saw with no tables.  the naive waveform is
+// calculated directly from the phase and corrected near each discontinuity
+// with a polynomial residual: polyblep for steps in value and polyblamp for
+// steps in slope.  phase is a 16 bit fraction of a cycle and amplitude is
+// 15 bits (one is 1 << 15), so everything fits in 32 bits.
+
+class BlepOsc : public BaseOscillator {
+public:
+  [[nodiscard]] int16_t next(int32_t phi) override;
+  AbsFreqParam& get_freq_param();
+protected:
+  explicit BlepOsc(float f);
+  static constexpr uint8_t PHASE_BITS = 16;
+  static constexpr uint32_t ONE = 1 << PHASE_BITS;
+  static constexpr uint8_t AMP_BITS = 15;
+  static constexpr int32_t AMP = 1 << AMP_BITS;
+  static uint32_t to_phase(uint32_t ticks);  // mod TIME_MODULUS
+  // residual (AMP scale) for a step from -1 to 1 at t = 0
+  [[nodiscard]] static int32_t blep(uint32_t t, uint32_t dt);
+  // residual (AMP scale) for a change in slope of AMP per sample at t = 0
+  [[nodiscard]] static int32_t blamp(uint32_t t, uint32_t dt);
+  // waveform (AMP scale) at phase t with dt phase per sample
+  [[nodiscard]] virtual int32_t at(uint32_t t, uint32_t dt) const = 0;
+private:
+  AbsFreqParam freq_param;
+};
+
+
+// matches Square (high for the first duty fraction of the cycle).
+
+class BlepSquare final : public BlepOsc {
+public:
+  class DutyParam final : public Param {
+  public:
+    explicit DutyParam(BlepSquare* o);
+    void set(float v) override;
+    float get() override;
+  private:
+    BlepSquare* oscillator;
+  };
+  friend class DutyParam;
+  BlepSquare(float f, float duty);
+  DutyParam& get_duty_param();
+private:
+  [[nodiscard]] int32_t at(uint32_t t, uint32_t dt) const override;
+  ATOMIC(uint32_t) duty;  // phase
+  DutyParam duty_param;
+};
+
+
+// matches Saw: offset 0 is a triangle, 1 a rising saw and -1 a falling
+// saw.  in between the corners (at peak and 1 - peak) are smoothed with
+// polyblamp; when a segment is shorter than a sample it is treated as a
+// step and smoothed with polyblep.
+
+class BlepSaw final : public BlepOsc {
+public:
+  class OffsetParam final : public Param {
+  public:
+    explicit OffsetParam(BlepSaw* o);
+    void set(float v) override;
+    float get() override;
+  private:
+    BlepSaw* oscillator;
+  };
+  friend class OffsetParam;
+  BlepSaw(float f, float offset);
+  OffsetParam& get_offset_param();
+private:
+  [[nodiscard]] int32_t at(uint32_t t, uint32_t dt) const override;
+  ATOMIC(uint32_t) peak;  // phase
+  ATOMIC(uint32_t) rise;  // slope (AMP per cycle) up to peak
+  ATOMIC(uint32_t) fall;  // half slope (AMP per cycle) down from peak
+  OffsetParam offset_param;
+};
 
 
 #endif
@@ -44,12 +44,22 @@ public:
   friend class WavedexMixin;
   BaseOscillator(uint32_t f, Wavetable *t);
   [[nodiscard]] int16_t next(int32_t phi) override;
+  // with a clock, time advances once per frame however many consumers
+  void set_clock(Clock* c);
+  [[nodiscard]] uint32_t get_evals() const;
+  [[nodiscard]] uint32_t get_repeats() const;  // evals after the first in a frame
 protected:
+  // increment time (if needed) and return the (modulated) time in ticks
+  int32_t advance(int32_t phi);
   ATOMIC(uint32_t) frequency;  // subtick units
   ATOMIC(AbsSource*) abs_source;
-private:
   static constexpr int32_t TIME_MODULUS = SAMPLE_RATE << SUBTICK_BITS;  // see discussion in oscillator.cpp
+private:
   int32_t tick = 0;
+  Clock* clock = nullptr;
+  uint32_t stamp = 0;
+  uint32_t evals = 0;
+  uint32_t repeats = 0;
 };
 
 
@@ -3,7 +3,9 @@
 #define COSAS_RANDOM_H
 
 
+#include <array>
 #include <cstdint>
+#include <span>
 
 
 // https://en.wikipedia.org/wiki/Xorshift
@@ -14,11 +16,24 @@ public:
   uint32_t next_uint32();
   int16_t next_int12();
   bool next_bool();
+  // fill a block with int12 values (SAMPLE_MIN to SAMPLE_MAX, no
+  // rejection) from LANES independent generators, interleaved.  the inner
+  // loop has no branches (and vectorises on the host).  the lanes are
+  // separate from the state used by the other methods.  values left over
+  // from a partial block are kept for the next call, so splitting a fill
+  // at any point gives the same values.
+  void fill(std::span<int16_t> out);
+  static constexpr size_t LANES = 4;
 private:
   void next_state();
   uint32_t state;
   uint32_t bit_index;
+  std::array<uint32_t, LANES> lanes;
+  std::array<int16_t, 2 * LANES> spare{};  // unused end of the last block
+  size_t spare_index = 2 * LANES;
   static int16_t uint16_to_int12(uint16_t val);
+  static int16_t scale_int12(uint32_t val);
+  void fill_block(int16_t* out);
 };
 
 #endif
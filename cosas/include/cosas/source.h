@@ -17,6 +17,9 @@ public:
   virtual ~RelSource() = default;
   // cannot be const because oscillator tracks absolute time
   [[nodiscard]] virtual int16_t next(int32_t phi) = 0;
+  // log2 of samples per call: 0 is audio rate; more is control rate, which
+  // must be called through Decimated (see control.h).
+  [[nodiscard]] virtual uint8_t rate_bits() const {return 0;};
 };
 
 
@@ -13,6 +13,8 @@
 
 
 class SingleSource : public RelSource {
+public:
+  [[nodiscard]] uint8_t rate_bits() const override {return src.rate_bits();};
 protected:
   explicit SingleSource(RelSource& src) : src(src) {};
   RelSource& src;
@@ -157,6 +159,7 @@ public:
   friend class Length;
   Boxcar(RelSource& src, size_t l);
   [[nodiscard]] int16_t next(int32_t phi) override;
+  [[nodiscard]] uint8_t rate_bits() const override {return 0;};  // length is in samples
   Length& get_len();
 private:
   std::unique_ptr<CircBuffer> cbuf;
@@ -191,6 +194,7 @@ public:
   void add_source(RelSource& src, float w);
   [[nodiscard]] Weight& get_weight(size_t i) const;
   [[nodiscard]] int16_t next(int32_t phi) override;
+  [[nodiscard]] uint8_t rate_bits() const override;  // fastest input
 protected:
   virtual void normalize();
   std::unique_ptr<std::vector<Weight>> weights;
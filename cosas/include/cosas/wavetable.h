@@ -99,7 +99,7 @@ protected:
 class Noise final : public FullWtable {
 public:
   Noise() : Noise(1) {};
-  explicit Noise(size_t smooth);
+  explicit Noise(size_t smooth, uint32_t seed = 0);  // fixed seed so output is repeatable
 };
 
 
@@ -0,0 +1,786 @@
+
+#ifndef COSAS_XQRIA_H
+#define COSAS_XQRIA_H
+
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <numbers>
+#include <numeric>
+#include <random>
+#include <span>
+#include <vector>
+
+
+// the dsp core of the xqria drum machine (arduino/xqria), which runs on an
+// esp32.  the dac, freertos, pots, buttons, leds and preferences stay in
+// the sketch.  this header uses only the standard library so that the
+// sketch can include it directly (arduino/xqria/xqria.h links here).
+
+// values are INTERNAL_BITS fixed point.  phase is TAU_BITS, which grows
+// with oversampling, so the phase increments in freq_table() do not change.
+// the per-sample code is templated on the oversampling (see oversampled()).
+
+namespace xqria {
+
+using uint = unsigned int;  // as the sketch (uint32_t is unsigned long on the esp32)
+
+constexpr uint BASE_RATE_HZ = 40000;
+constexpr uint INTERNAL_BITS = 16;
+constexpr uint INTERNAL_N = 1 << INTERNAL_BITS;
+constexpr uint INTERNAL_MAX = INTERNAL_N - 1;
+constexpr uint INTERNAL_MSB = INTERNAL_N >> 1;
+constexpr uint TABLE_BITS = 12;
+constexpr uint TABLE_N = 1 << TABLE_BITS;
+constexpr uint FREQ_BITS = 7;
+constexpr uint FREQ_N = 1 << FREQ_BITS;  // 128 - 10 octaves from 20hz to 20khz, 12 notes per octave
+constexpr uint A_IDX = 61;  // from trial and error (location of 440hz)
+constexpr uint AMP_BITS = 7;
+constexpr uint AMP_N = 1 << AMP_BITS;
+constexpr uint MAX_COMP_BITS = 12;
+constexpr uint REVERB_BITS = 13;
+constexpr uint REVERB_EXTRA = 4;
+constexpr uint REVERB_DENOM_BITS = 12;
+constexpr uint N_VOICES = 4;
+constexpr std::array<uint, 16> SUBDIVS = {5, 10, 12, 15, 20, 24, 25, 30, 35, 36, 40, 45, 48, 50, 55, 60};  // by luck length is power of 2
+
+
+// everything that depends on oversampling (which can change while running)
+struct Rate {
+  uint oversample_bits;
+  uint sample_rate_hz;
+  uint beat_scale;  // ticks for 1 bpm
+  uint tau_bits;
+  uint tau_n;
+  uint tau_max;
+  explicit constexpr Rate(const uint oversample_bits)
+    : oversample_bits(oversample_bits), sample_rate_hz(BASE_RATE_HZ << oversample_bits), beat_scale(sample_rate_hz * 60),
+      tau_bits(INTERNAL_BITS + 1 + oversample_bits), tau_n(1u << tau_bits), tau_max(tau_n - 1) {};
+};
+
+
+template<typename T> int sgn(T val) {
+  return (T(0) < val) - (val < T(0));
+}
+
+inline uint umult(uint a, uint b) {
+  return (a * b) >> INTERNAL_BITS;
+}
+
+inline int imult(int a, int b) {
+  return (a * b) >> INTERNAL_BITS;
+}
+
+inline uint gray(uint n) {
+  return n ^ (n >> 1);
+}
+
+template<uint BITS> uint array_lookup(const std::array<uint, 1 << BITS>& data, uint idx) {
+  return data[idx >> (INTERNAL_BITS - BITS)];
+}
+
+template<uint BITS> uint array_lookup_msb(const std::array<uint, 1 << BITS>& data, uint idx) {
+  return data[(idx & 0x7fff) >> (INTERNAL_BITS - 1 - BITS)];
+}
+
+inline uint non_linear(uint val, uint n) {
+  if (n == 0) return 1;
+  else if (n == 1) return val;
+  uint val2 = umult(val, val);
+  if (n == 2) return (val + val2) >> 1;
+  uint val3 = umult(val, val2);
+  if (n == 3) return (val + val2 + 2 * val3) >> 2;
+  uint val4 = umult(val, val3);
+  return (val + (val2 << 1) + (val3 << 2) + val4 + (val4 << 3)) >> 4;
+}
+
+
+// phase increments for semitones (the same for all oversampling, see above)
+inline const std::array<uint, FREQ_N>& freq_table() {
+  static const std::array<uint, FREQ_N> table = [] {
+    std::array<uint, FREQ_N> t{};
+    const Rate rate(0);
+    const auto in_range = [](int idx) {return idx > -1 && idx < static_cast<int>(FREQ_N);};
+    const auto to_phase = [&](float f) {
+      return static_cast<uint>(0.5f + (f * static_cast<float>(rate.tau_n)) / static_cast<float>(rate.sample_rate_hz));
+    };
+    const auto around = [&](float a, int a_idx) {
+      if (in_range(a_idx)) t[a_idx] = to_phase(a);
+      for (int i = 1; i < 7; i++) {
+        if (in_range(a_idx + i)) t[a_idx + i] = to_phase(a * std::pow(2.0f, static_cast<float>(i) / 12.0f));
+      }
+      for (int i = 1; i < 6; i++) {
+        if (in_range(a_idx - i)) t[a_idx - i] = to_phase(a * std::pow(2.0f, static_cast<float>(-i) / 12.0f));
+      }
+    };
+    for (int a_idx = A_IDX; a_idx > -12; a_idx -= 12) around(440 * std::ldexp(1.0f, (a_idx - static_cast<int>(A_IDX)) / 12), a_idx);
+    for (int a_idx = A_IDX + 12; a_idx < static_cast<int>(FREQ_N) + 12; a_idx += 12) around(440 * std::ldexp(1.0f, (a_idx - static_cast<int>(A_IDX)) / 12), a_idx);
+    return t;
+  }();
+  return table;
+}
+
+// exponential amplitudes (1 to INTERNAL_MAX)
+inline const std::array<uint, AMP_N>& amp_table() {
+  static const std::array<uint, AMP_N> table = [] {
+    std::array<uint, AMP_N> t{};
+    const float k = std::pow(2.0f, INTERNAL_BITS / static_cast<float>(AMP_N - 1));
+    for (uint i = 0; i < AMP_N; i++) {
+      t[i] = std::min(INTERNAL_MAX, static_cast<uint>(0.5f + std::pow(k, static_cast<float>(i))));
+    }
+    return t;
+  }();
+  return table;
+}
+
+
+// efficient random bits from an LFSR (random quality is not important here!)
+class LFSR16 {
+private:
+  uint state;
+public:
+  explicit LFSR16(uint seed = 0xace1u) : state(seed) {}
+  int next(uint scale) {
+    uint lsb = state & 0x1;
+    state >>= 1;
+    if (lsb) {
+      state ^= 0xb400;
+      return static_cast<int>(scale);
+    } else {
+      return -static_cast<int>(scale);
+    }
+  }
+  uint get_state() {
+    next(1);
+    return state;
+  }
+};
+
+
+// exponential moving average used for smoothing time series
+template<typename T> class EMA {
+private:
+  uint bits;
+  uint denom;
+  uint xtra;
+  T state;
+protected:
+  virtual T get_state() {
+    return state;
+  }
+  virtual void set_state(T s) {
+    state = s;
+  }
+public:
+  uint num;
+  EMA(uint bits, uint num, uint xtra, T state) : bits(bits), denom(1 << bits), xtra(xtra), state(state << xtra), num(num) {};
+  virtual ~EMA() = default;
+  T next(T val) {
+    set_state((get_state() * static_cast<T>(denom - num) + (val << xtra) * static_cast<T>(num)) >> bits);
+    return read();
+  }
+  T read() {
+    return get_state() >> xtra;
+  }
+};
+
+
+// waveforms for the first quarter of a cycle.  lookup() takes phase at
+// TAU_BITS (so the shifts are constants) and is called via Quarter.
+
+class Lookup {
+public:
+  template<uint TAU_BITS> uint lookup(uint phase) const {
+    static_assert(TAU_BITS >= TABLE_BITS);
+    return table[phase >> (TAU_BITS - TABLE_BITS)];
+  }
+protected:
+  std::array<uint16_t, 1 + TABLE_N / 4> table{};
+  static double sine(uint i) {
+    return std::sin(2 * std::numbers::pi * i / TABLE_N);
+  }
+};
+
+class Sine : public Lookup {
+public:
+  Sine() : Lookup() {
+    for (uint i = 0; i < 1 + (TABLE_N / 4); i++) table[i] = static_cast<uint16_t>(INTERNAL_MAX * sine(i));
+  }
+};
+
+class TriangleMinusSine : public Lookup {
+public:
+  explicit TriangleMinusSine(double k) : Lookup() {
+    const auto f = [k](uint i) {return (i << (INTERNAL_BITS - (TABLE_BITS - 2))) - k * INTERNAL_MAX * sine(i);};
+    double norm = 0;
+    for (uint i = 0; i < 1 + (TABLE_N / 4); i++) norm = std::max(norm, f(i));
+    norm = INTERNAL_MAX / norm;
+    for (uint i = 0; i < 1 + (TABLE_N / 4); i++) table[i] = static_cast<uint16_t>(norm * std::max(0.0, f(i)));
+  }
+};
+
+class SquareMinusSine : public Lookup {
+public:
+  explicit SquareMinusSine(double k) : Lookup() {
+    const auto f = [k](uint i) {return INTERNAL_MAX * (1 - k * sine(i));};
+    double norm = 0;
+    for (uint i = 0; i < 1 + (TABLE_N / 4); i++) norm = std::max(norm, f(i));
+    norm = INTERNAL_MAX / norm;
+    for (uint i = 0; i < 1 + (TABLE_N / 4); i++) table[i] = static_cast<uint16_t>(norm * std::max(0.0, f(i)));
+  }
+};
+
+// implement square (no need for table, can just use constant)
+class Square {
+public:
+  template<uint TAU_BITS> uint lookup(uint) const {
+    return INTERNAL_MAX;
+  }
+};
+
+class Triangle {
+public:
+  template<uint TAU_BITS> uint lookup(uint phase) const {
+    if constexpr ((TAU_BITS - 2) < INTERNAL_BITS) {
+      return phase << (INTERNAL_BITS - (TAU_BITS - 2));
+    } else {
+      return phase >> ((TAU_BITS - 2) - INTERNAL_BITS);
+    }
+  }
+};
+
+inline const Sine SINE;
+inline const TriangleMinusSine TM81S(0.81);
+inline const TriangleMinusSine TM50S(0.50);
+inline const SquareMinusSine SM50S(0.50);
+inline const Square SQUARE;
+inline const Triangle TRIANGLE;
+
+// quarter wave lookup (don't need to store complete sine wave; only first
+// quarter).  a functor for one waveform at one oversampling (tau), so that
+// everything is static and inlined, eg Quarter<SINE, Rate(1).tau_bits>.
+template<const auto& WAVE, uint TAU_BITS> class Quarter {
+public:
+  static constexpr uint TAU_N = 1u << TAU_BITS;
+  static constexpr uint HALF = TAU_N >> 1;
+  static constexpr uint QUARTER = HALF >> 1;
+  int operator()(uint amp, uint phase) const {
+    int sign = 1;
+    if (phase >= HALF) {
+      phase = TAU_N - phase;
+      sign = -1;
+    };
+    if (phase >= QUARTER) phase = HALF - phase;
+    return sign * static_cast<int>(umult(amp, WAVE.template lookup<TAU_BITS>(phase)));
+  }
+};
+
+// call f with std::integral_constant<uint, oversample_bits>, so that the
+// caller runs a specialisation for each oversampling
+constexpr uint MAX_OVERSAMPLE_BITS = 3;  // two bits in the ui
+template<typename F> decltype(auto) oversampled(uint oversample_bits, F&& f) {
+  switch (oversample_bits) {
+  case 0: return f(std::integral_constant<uint, 0>());
+  case 1: return f(std::integral_constant<uint, 1>());
+  case 2: return f(std::integral_constant<uint, 2>());
+  default: return f(std::integral_constant<uint, MAX_OVERSAMPLE_BITS>());
+  }
+}
+
+
+class HiPass {
+private:
+  int prev_in = 0;
+  int prev_out = 0;
+  int alpha;
+public:
+  explicit HiPass(int alpha) : alpha(alpha) {};
+  int next(int in, int alpha2) {
+    alpha = alpha2;
+    return next(in);
+  }
+  int next(int in) {
+    prev_out = imult(alpha, prev_out + in - prev_in);
+    prev_in = in;
+    return prev_out;
+  }
+};
+
+class LoPass {
+private:
+  int prev_out = 0;
+  int alpha;
+  int beta;
+public:
+  explicit LoPass(int alpha) : alpha(alpha), beta(static_cast<int>(INTERNAL_MAX) - alpha) {};
+  int next(int in, int alpha2) {
+    alpha = alpha2;
+    beta = static_cast<int>(INTERNAL_MAX) - alpha;
+    return next(in);
+  }
+  int next(int in) {
+    prev_out = imult(alpha, in) + imult(beta, prev_out);
+    return prev_out;
+  }
+};
+
+
+// generate the sound for each voice (which means tracking time and phase).
+// the msbs of freq and amp select the drum (kick, snare, ride, crash).
+class Voice {
+private:
+  uint time = 0;  // ticks since triggered
+  int phase = 0;
+  int fm_phase = 0;
+  volatile bool on = false;
+  HiPass hp;
+  LoPass lp;
+  LFSR16 lfsr;
+  template<uint OVERSAMPLE_BITS> static int norm_phase(int phase) {
+    return phase & static_cast<int>(Rate(OVERSAMPLE_BITS).tau_max);
+  }
+  template<const auto& WAVE, uint OVERSAMPLE_BITS> static int quarter(uint amp, uint phase) {
+    return Quarter<WAVE, Rate(OVERSAMPLE_BITS).tau_bits>()(amp, phase);
+  }
+public:
+  const uint idx;
+  // parameters modified by UI (all INTERNAL_BITS)
+  volatile uint amp;
+  volatile uint freq;
+  volatile uint durn;
+  volatile uint fm;
+  volatile int shift;
+  Voice(uint idx, uint amp, uint freq, uint durn, uint fm, int shift)
+    : hp(INTERNAL_MAX >> 1), lp(INTERNAL_MAX >> 3), lfsr(0xace1u + idx), idx(idx), amp(amp), freq(freq), durn(durn), fm(fm), shift(shift) {};
+  void trigger() {
+    on = true;
+    time = 0;
+    phase = 0;
+    fm_phase = 0;
+  }
+  [[nodiscard]] bool active() const {
+    return on;
+  }
+  int output(const Rate& rate) {
+    return oversampled(rate.oversample_bits, [this](auto os) {return output<decltype(os)::value>();});
+  }
+  template<uint OVERSAMPLE_BITS> int output() {
+    if (!on) return 0;
+    // sampling freq is 15.5 bits, internal is 16 bits, would like max durn to be about 4s.
+    uint durn_scaled;
+    if constexpr (OVERSAMPLE_BITS > 1) durn_scaled = non_linear(durn, 2) << (OVERSAMPLE_BITS - 1);
+    else durn_scaled = non_linear(durn, 2) >> (1 - OVERSAMPLE_BITS);
+    if (time >= durn_scaled) {
+      on = false;
+      return 0;
+    }
+    uint rise = (((INTERNAL_MAX >> 4) * time) / (durn_scaled + 1)) << 4;
+    uint dec = INTERNAL_MAX - rise;
+    uint nv_freq = freq;
+    uint exp_freq = array_lookup_msb<FREQ_BITS>(freq_table(), nv_freq);
+    uint nv_amp = amp;
+    uint exp_amp = array_lookup_msb<AMP_BITS>(amp_table(), nv_amp);
+    int out = 0;
+    if (nv_freq & INTERNAL_MSB) {
+      if (nv_amp & INTERNAL_MSB) {
+        out = crash<OVERSAMPLE_BITS>(exp_amp, exp_freq << 1, fm, non_linear(dec, 2));
+      } else {
+        uint env = std::min(rise << 1, array_lookup<AMP_BITS>(amp_table(), dec));
+        out = ride<OVERSAMPLE_BITS>(exp_amp << 2, exp_freq << 1, fm, env);
+      }
+    } else {
+      if (nv_amp & INTERNAL_MSB) {
+        out = snare<OVERSAMPLE_BITS>(exp_amp, exp_freq >> 1, fm, dec);
+      } else {
+        out = kick<OVERSAMPLE_BITS>(exp_amp << 2, exp_freq >> 4, fm, dec);
+      }
+    }
+    time++;
+    return out;
+  }
+  template<uint OS> int snare(uint amp, uint freq, uint fm, uint dec) {
+    uint dec2 = umult(dec, dec);
+    fm_phase = norm_phase<OS>(fm_phase + static_cast<int>(fm >> 6));
+    phase = norm_phase<OS>(phase + static_cast<int>(freq) + quarter<SM50S, OS>(dec2 >> 6, fm_phase));
+    int noisy = quarter<TM50S, OS>(dec, phase) + lfsr.next(umult(fm, dec2) >> 2);
+    return lp.next(imult(static_cast<int>(amp), noisy), static_cast<int>(dec >> 1));
+  }
+  template<uint OS> int kick(uint amp, uint freq, uint fm, uint dec) {
+    uint dec2 = umult(dec, dec);
+    uint local_freq = freq + (umult(fm, dec2) >> 6);
+    phase = norm_phase<OS>(phase + static_cast<int>(local_freq));
+    fm_phase = norm_phase<OS>(fm_phase + static_cast<int>(local_freq >> 3));
+    uint local_amp = umult(amp, dec);
+    return quarter<SINE, OS>(local_amp, phase) + quarter<TM50S, OS>(local_amp >> 2, fm_phase);
+  }
+  template<uint OS> int crash(uint amp, uint freq, uint fm, uint dec) {
+    uint dec2 = umult(dec, dec);
+    fm_phase = norm_phase<OS>(fm_phase + static_cast<int>(fm));
+    phase = norm_phase<OS>(phase + static_cast<int>(freq) + quarter<SM50S, OS>(dec, fm_phase) + lfsr.next(dec2 >> 2));
+    return imult(static_cast<int>(amp), quarter<SINE, OS>(dec, phase));
+  }
+  template<uint OS> int ride(uint amp, uint freq, uint fm, uint env) {
+    fm_phase = norm_phase<OS>(fm_phase + static_cast<int>(fm));
+    phase = norm_phase<OS>(phase + static_cast<int>(freq) + quarter<TRIANGLE, OS>(INTERNAL_MAX, fm_phase));
+    int out = imult(static_cast<int>(amp), quarter<SINE, OS>(env, phase) + lfsr.next(imult(static_cast<int>(fm), static_cast<int>(env)) >> 4));
+    return hp.next(out, static_cast<int>((INTERNAL_MAX - env) >> 1));
+  }
+  // copy parameters (to another voice or saved data)
+  template<typename T> void to(T& other) const {
+    other.amp = amp;
+    other.freq = freq;
+    other.durn = durn;
+    other.fm = fm;
+    other.shift = shift;
+  }
+  template<typename T> void from(const T& other) {
+    amp = other.amp;
+    freq = other.freq;
+    durn = other.durn;
+    fm = other.fm;
+    shift = other.shift;
+  }
+};
+
+
+// standard euclidean pattern.  on_beat() returns the voice to trigger (or -1).
+class Euclidean {
+private:
+  uint n_places;
+  uint n_beats;
+  float frac_main;
+  uint n_main;
+  uint prob;
+  uint voice;
+  uint current_place = 0;
+  std::minstd_rand rng;
+  std::vector<uint> place_ref;       // beat index -> place index (reference)
+  std::vector<uint> place_off;       // beat index -> place index (offset)
+  std::vector<int> error;            // beat index -> error x INTERNAL_MAX
+  std::vector<uint> index_by_error;  // error (abs(error) increasing) -> beat index
+  std::vector<bool> is_main;         // beat index -> true if main (small error)
+  std::vector<int> index_by_place;   // (offset) place index -> beat index (or -1)
+  uint random(uint n) {
+    return static_cast<uint>(rng() % n);
+  }
+  [[nodiscard]] bool empty(uint place) const {
+    return place < n_places && index_by_place[place] == -1;  // out of range wraps to a large uint
+  }
+public:
+  // 1 <= n_beats <= n_places
+  Euclidean(uint n_places, uint n_beats, float frac_main, uint prob, uint voice, uint seed = 1)
+    : n_places(n_places), n_beats(n_beats), frac_main(std::max(0.0f, std::min(1.0f, frac_main))), prob(prob), voice(voice), rng(seed) {
+    for (uint i = 0; i < n_beats; i++) {
+      float x = static_cast<float>(n_places * i) / static_cast<float>(n_beats);
+      place_ref.push_back(static_cast<uint>(std::round(x)));
+      place_off.push_back(static_cast<uint>(std::round(x)));
+      error.push_back(static_cast<int>(INTERNAL_MAX * (x - std::round(x))));
+    }
+    std::vector<int> regular(n_beats, 0);
+    int penalty = INTERNAL_MAX;
+    for (uint i = 0; i < n_beats; i++) {
+      if (error[i]) penalty = std::min(penalty, std::abs(error[i]));
+    }
+    penalty /= 2;
+    // should penalty be +ve or -ve?
+    if (random(2)) penalty = -1 * penalty;
+    for (uint i = 2; i < n_beats; i++) {
+      if (!(n_beats % i) && !(n_places % i)) {
+        for (uint j = 0; j < n_beats; j += i) regular[j] = penalty;
+        penalty /= 2;
+      }
+    }
+    for (uint i = 0; i < n_beats; i++) {
+      if (!error[i]) error[i] = regular[i];
+    }
+    index_by_error.resize(n_beats, 0);
+    std::iota(index_by_error.begin(), index_by_error.end(), 0);
+    std::sort(index_by_error.begin(), index_by_error.end(), [this](uint i, uint j) {
+      return std::abs(this->error[i]) < std::abs(this->error[j]);
+    });
+    n_main = std::min(n_beats, static_cast<uint>(std::round(static_cast<float>(n_beats) * this->frac_main)));
+    is_main.resize(n_beats, false);
+    for (uint i = 0; i < n_main; i++) is_main[index_by_error[i]] = true;
+    index_by_place.resize(n_places, -1);
+    for (uint i = 0; i < n_beats; i++) index_by_place[place_off[i]] = static_cast<int>(i);
+  };
+  Euclidean() : Euclidean(2, 1, 0.5, INTERNAL_MAX, 0) {};  // used only as temp value in arrays
+  bool operator==(const Euclidean& other) const {
+    return other.n_places == n_places && other.n_beats == n_beats && other.n_main == n_main && other.prob == prob && other.voice == voice;
+  }
+  [[nodiscard]] uint get_n_places() const {
+    return n_places;
+  }
+  void jiggle() {
+    // error is signed to MAX11 (MAX12 * 0.5) while prob is unisgned MAX12
+    for (uint i = 0; i < n_beats - n_main; i++) {
+      uint frac_m12 = (prob * static_cast<uint>(std::abs(error[i]))) >> 11;
+      if (random(INTERNAL_MAX) < frac_m12) {
+        if (place_ref[i] == place_off[i]) {
+          if (error[i] > 0 && empty(place_off[i] + 1)) {
+            place_off[i]++;
+            index_by_place[place_off[i]] = static_cast<int>(i);
+            index_by_place[place_ref[i]] = -1;
+          } else if (error[i] < 0 && empty(place_off[i] - 1)) {
+            place_off[i]--;
+            index_by_place[place_off[i]] = static_cast<int>(i);
+            index_by_place[place_ref[i]] = -1;
+          }
+        } else {
+          if (error[i] > 0 && empty(place_ref[i])) {
+            index_by_place[place_off[i]] = -1;
+            place_off[i]--;
+            index_by_place[place_ref[i]] = static_cast<int>(i);
+          } else if (error[i] < 0 && empty(place_ref[i])) {
+            index_by_place[place_off[i]] = -1;
+            place_off[i]++;
+            index_by_place[place_ref[i]] = static_cast<int>(i);
+          }
+        }
+        return;
+      }
+    }
+  }
+  int on_beat(bool main) {
+    int beat = index_by_place[current_place];
+    int triggered = -1;
+    if (beat != -1 && is_main[beat] == main) triggered = static_cast<int>(voice + (main ? 0 : 1));
+    if (!main) {  // main is done before minor
+      if (++current_place == n_places) current_place = 0;
+    }
+    return triggered;
+  }
+};
+
+
+// handle passing of complex state between threads (everything else is a volatile uint, i think, but the Euclidean class is complex)
+// this stores three things:
+// - a set of values to create "the next" euclidean object while editing is in progress
+// - a "next" euclidean object created when editing last exited
+// - a "current" euclidean object that is used for sound generation
+// it is responsible for:
+// - creation of the "next" instance when editing finishes
+// - moving "next" to "current" when a new cycle begins (avoiding copy/assignment)
+// - holding the "current" instance in memory while it is in use
+// - avoiding access conflicts
+class EuclideanVault {
+private:
+  std::mutex access;
+  Euclidean euclideans[2];
+  bool updated = false;
+  uint current = 0;
+  uint next = 1;
+  uint seed = 1;
+  [[nodiscard]] uint n_beats() const {
+    return std::max(1u, static_cast<uint>(static_cast<float>(n_places) * frac_beats));
+  }
+public:
+  uint voice;
+  uint n_places;
+  float frac_beats;
+  float frac_main;
+  uint prob;
+  EuclideanVault(uint n_places, float frac_beats, float frac_main, uint prob, uint voice)
+    : voice(voice), n_places(n_places), frac_beats(frac_beats), frac_main(frac_main), prob(prob) {
+    euclideans[0] = Euclidean(n_places, n_beats(), frac_main, prob, voice, seed++);
+    euclideans[1] = Euclidean(n_places, n_beats(), frac_main, prob, voice, seed++);
+  }
+  void apply_edit() {
+    std::lock_guard<std::mutex> lock(access);
+    Euclidean candidate = Euclidean(n_places, n_beats(), frac_main, prob, voice, seed);
+    if (euclideans[updated ? next : current] != candidate) {
+      euclideans[next] = candidate;
+      updated = true;
+      seed++;
+    }
+  };
+  Euclidean* get() {
+    std::unique_lock<std::mutex> lock(access, std::defer_lock);
+    if (lock.try_lock() && updated) {
+      std::swap(current, next);
+      updated = false;
+    }
+    return &euclideans[current];
+  }
+};
+
+
+// global timing (modified by UI)
+struct Timing {
+  volatile uint bpm = 200;
+  volatile uint subdiv_idx = 15;
+  volatile uint patt_offset = 0;
+};
+
+
+// schedule beats from a vault's rhythm.  on() returns the voice to trigger (or -1).
+class Trigger {
+private:
+  EuclideanVault& vault;
+  const Voice& voice;
+  const Timing& timing;
+  bool major;
+  bool subdiv;
+  Euclidean* rhythm = nullptr;
+  enum Phase {Idle, Jiggle, Update};
+  Phase phase = Idle;
+  int offset = 0;
+  int64_t trigger = 0;
+  void recalculate(int64_t ticks, const Rate& rate) {
+    rhythm = vault.get();
+    uint nv_bpm = timing.bpm;
+    uint nv_interval = rate.beat_scale / nv_bpm;
+    if (subdiv) nv_interval = (nv_interval * SUBDIVS[timing.subdiv_idx]) / 60;
+    int64_t beat = 1 + (ticks / nv_interval);
+    trigger = nv_interval * beat;
+    if (subdiv) {
+      offset = static_cast<int>(timing.patt_offset * rate.beat_scale / nv_bpm);
+      int voice_offset = (voice.shift * static_cast<int>(nv_interval >> 4)) >> (INTERNAL_BITS - 5);  // spread bits to avoid overflow
+      offset += voice_offset;
+    }
+  }
+public:
+  Trigger(EuclideanVault& vault, const Voice& voice, const Timing& timing, bool major, bool subdiv, const Rate& rate)
+    : vault(vault), voice(voice), timing(timing), major(major), subdiv(subdiv) {
+    recalculate(0, rate);
+  }
+  int on(int64_t ticks, const Rate& rate) {  // try to spread work across multiple ticks
+    int triggered = -1;
+    ticks += offset;
+    if (phase == Idle && ticks > trigger) {
+      triggered = rhythm->on_beat(major);
+      phase = Jiggle;
+    } else if (phase == Jiggle) {
+      rhythm->jiggle();
+      phase = Update;
+    } else if (phase == Update) {
+      recalculate(ticks, rate);
+      phase = Idle;
+    }
+    return triggered;
+  }
+};
+
+
+// reverb via array of values (could maybe save space with int16, but store extra bits to reduce noise)
+template<uint BITS> class Reverb {
+private:
+  static constexpr uint max_size = 1 << BITS;
+  int tape[max_size] = {};
+  uint write = 0;
+
+  class TapeEMA : public EMA<int> {
+  private:
+    Reverb<BITS>* reverb;
+  protected:
+    int get_state() override {
+      return reverb->tape[reverb->write];
+    }
+    void set_state(int val) override {
+      reverb->tape[reverb->write] = val;
+    }
+  public:
+    TapeEMA(Reverb<BITS>* reverb, uint bits, uint num, uint xtra) : EMA<int>(bits, num, xtra, 0), reverb(reverb) {};
+  };
+
+public:
+  uint size = max_size;
+  TapeEMA head;
+  Reverb() : head(TapeEMA(this, REVERB_DENOM_BITS, 1 << REVERB_DENOM_BITS, REVERB_EXTRA)) {};  // by default disabled
+  Reverb(const Reverb&) = delete;
+  int next(int val) {
+    write = (write + 1) % std::min(max_size, std::max(1u, size));  // can't be "& mask" because size can vary
+    return head.next(val);
+  }
+};
+
+
+inline int compress(int out, uint bits, uint ceiling) {
+  int sign = sgn(out);
+  uint absolute = static_cast<uint>(std::abs(out));
+  bits = std::min(bits, ceiling);
+  for (uint i = (ceiling - bits); i < ceiling; i++) {
+    uint limit = 1 << i;
+    if (absolute > limit) absolute = limit + ((absolute - limit) >> 1);
+    else break;
+  }
+  return sign * static_cast<int>(absolute);
+}
+
+inline int drop_bits(int amp, uint bits) {
+  if (bits) {
+    int k = 1 << bits;
+    return k * (amp / k);
+  } else {
+    return amp;
+  }
+}
+
+
+// the four voices, two patterns (two voices each) and post-processing,
+// generating unsigned 8 bit samples for the dac.
+class Audio {
+private:
+  int64_t ticks = 0;
+public:
+  // parameters modified by UI
+  std::array<Voice, N_VOICES> voices = {Voice(0, 0xff00, 160 << 4, 0xff00, 0xff00, 0),
+                                        Voice(1, 0x7fff, 240 << 4, 0xff00, 0xff00, 0),
+                                        Voice(2, 0x7fff, 213 << 4, 0xff00, 0xff00, 0),
+                                        Voice(3, 0x7fff, 320 << 4, 0xff00, 0xff00, 0)};
+  std::array<EuclideanVault, 2> vaults = {EuclideanVault(16, 0.666f, 0.5f, 0, 0), EuclideanVault(25, 0.666f, 0.5f, 0x7fff, 2)};
+  Reverb<REVERB_BITS> reverb;
+  Timing timing;
+  volatile uint oversample_bits = 1;
+  volatile uint enabled = 0xf;  // mask of voices
+  volatile uint comp_bits = 0;
+  volatile uint drop_bits = 0;
+private:
+  std::array<Trigger, N_VOICES> triggers = {Trigger(vaults[0], voices[0], timing, true, false, rate()),
+                                            Trigger(vaults[0], voices[1], timing, false, false, rate()),
+                                            Trigger(vaults[1], voices[2], timing, true, true, rate()),
+                                            Trigger(vaults[1], voices[3], timing, false, true, rate())};
+public:
+  Audio() = default;
+  Audio(const Audio&) = delete;
+  [[nodiscard]] Rate rate() const {
+    return Rate(std::min(MAX_OVERSAMPLE_BITS, static_cast<uint>(oversample_bits)));
+  }
+  // apply post-processing
+  uint8_t post_process(int amp) {
+    // apply compressor
+    int soft_clipped = compress(amp, comp_bits, MAX_COMP_BITS);
+    // apply reverb
+    int reverbed = reverb.next(soft_clipped);
+    // apply quantisation
+    int shifted = xqria::drop_bits(reverbed, drop_bits);
+    // hard clip
+    int offset = shifted + 0x80;
+    return static_cast<uint8_t>(std::max(0, std::min(0xff, offset)));
+  }
+  // oversampling is fixed for each call
+  void generate(std::span<uint8_t> data) {
+    oversampled(oversample_bits, [this, data](auto os) {generate<decltype(os)::value>(data);});
+  }
+  template<uint OVERSAMPLE_BITS> void generate(std::span<uint8_t> data) {
+    constexpr Rate r(OVERSAMPLE_BITS);
+    for (uint8_t& sample : data) {
+      uint j = ticks & 0x3;  // really subtle fix - we can get rhythms switching on the same beat if these don't match
+      int v = triggers[j].on(ticks - j, r);
+      if (v >= 0 && (enabled & (1u << v))) voices[v].trigger();
+      ticks++;
+      int vol = 0;
+      for (Voice& voice : voices) vol += voice.output<OVERSAMPLE_BITS>();
+      sample = post_process(vol >> 2);  // avg
+    }
+  }
+};
+
+}
+
+
+#endif
@@ -0,0 +1,135 @@
+
+#include <algorithm>
+#include <numbers>
+
+#include "cosas/control.h"
+#include "cosas/maths.h"
+
+
+Decimated::Decimated(RelSource& src, const bool hold)
+  : src(src), bits(src.rate_bits()), mask((1u << bits) - 1), hold(hold) {};
+
+int16_t Decimated::next(const int32_t phi) {
+  if (!count) {
+    // start of block, so interpolate towards the value at the end
+    value = target;
+    target = src.next(phi) << FRAC_BITS;
+    step = hold ? 0 : (target - value) >> bits;
+    if (hold) value = target;
+  } else {
+    value += step;
+  }
+  count = (count + 1) & mask;
+  return static_cast<int16_t>(value >> FRAC_BITS);
+}
+
+
+ControlSource::ControlSource(const float hz) : rate_param(this) {
+  // cannot be set directly as may be atomic
+  delta = hz2delta(hz);
+}
+
+uint32_t ControlSource::hz2delta(const float hz) {
+  const float cycles = std::max(0.0f, hz) * CONTROL_N / static_cast<float>(SAMPLE_RATE);
+  return static_cast<uint32_t>(std::min(0.5f, cycles) * 4294967296.0f);
+}
+
+int16_t ControlSource::next(int32_t /* phi */) {
+  phase += LOAD(delta);
+  return previous = at(phase);
+}
+
+ControlSource::RateParam& ControlSource::get_rate_param() {
+  return rate_param;
+}
+
+
+ControlSource::RateParam::RateParam(ControlSource* s)
+  : Param(0.5, 0, true, -2, log10f(50)), source(s) {};
+
+void ControlSource::RateParam::set(const float hz) {
+  source->delta = hz2delta(clip(hz));
+}
+
+float ControlSource::RateParam::get() {
+  return static_cast<float>(LOAD(source->delta)) / 4294967296.0f * static_cast<float>(SAMPLE_RATE) / CONTROL_N;
+}
+
+
+Lfo::Lfo(const float hz, const Shape s) : ControlSource(hz), sines(sine_table()), shape_param(this) {
+  // cannot be set directly as may be atomic
+  shape = s;
+}
+
+const std::array<int16_t, (1 << Lfo::SINE_BITS) + 1>& Lfo::sine_table() {
+  static std::array<int16_t, (1 << SINE_BITS) + 1> table = [] {
+    std::array<int16_t, (1 << SINE_BITS) + 1> t{};
+    for (size_t i = 0; i < t.size(); i++) {
+      t[i] = static_cast<int16_t>(SAMPLE_MAX * sinf(2 * std::numbers::pi_v<float> * static_cast<float>(i) / (1 << SINE_BITS)));
+    }
+    return t;
+  }();
+  return table;
+}
+
+int16_t Lfo::at(const uint32_t phase) const {
+  switch (LOAD(shape)) {
+  default:
+  case SINE: {
+    const uint32_t idx = phase >> (32 - SINE_BITS);
+    const int32_t frac = static_cast<int32_t>((phase >> (16 - SINE_BITS)) & 0xffff);
+    return static_cast<int16_t>(sines[idx] + (((sines[idx + 1] - sines[idx]) * frac) >> 16));
+  }
+  case TRIANGLE: {
+    // fold the saw
+    const uint32_t p = phase + (1u << 30);  // start at zero, rising
+    const auto up = static_cast<int64_t>(p & 0x7fffffff) * (2 * SAMPLE_MAX) >> 31;
+    return static_cast<int16_t>(p & 0x80000000 ? SAMPLE_MAX - up : SAMPLE_MIN + up);
+  }
+  case SAW:
+    return static_cast<int16_t>(SAMPLE_MIN + (static_cast<int64_t>(phase) * (2 * SAMPLE_MAX) >> 32));
+  case SQUARE:
+    return phase & 0x80000000 ? SAMPLE_MIN : SAMPLE_MAX;
+  }
+}
+
+Lfo::ShapeParam& Lfo::get_shape_param() {
+  return shape_param;
+}
+
+
+Lfo::ShapeParam::ShapeParam(Lfo* l) : Param(1, 1, false, 0, N_SHAPES - 1), lfo(l) {};
+
+void Lfo::ShapeParam::set(const float v) {
+  lfo->shape = static_cast<uint8_t>(std::min(static_cast<float>(N_SHAPES - 1), std::max(0.0f, v)));
+}
+
+float Lfo::ShapeParam::get() {
+  return LOAD(lfo->shape);
+}
+
+
+Envelope::Envelope(const float hz, const float a) : ControlSource(hz), attack_param(this) {
+  attack_param.set(a);
+}
+
+int16_t Envelope::at(const uint32_t phase) const {
+  const uint32_t a = LOAD(attack);
+  if (phase < a) return static_cast<int16_t>(static_cast<int64_t>(phase) * SAMPLE_MAX / a);
+  return static_cast<int16_t>(static_cast<int64_t>(~phase) * SAMPLE_MAX / ~a);
+}
+
+Envelope::AttackParam& Envelope::get_attack_param() {
+  return attack_param;
+}
+
+
+Envelope::AttackParam::AttackParam(Envelope* e) : Param(1, 1, false, 0.01f, 0.99f), envelope(e) {};
+
+void Envelope::AttackParam::set(const float v) {
+  envelope->attack = static_cast<uint32_t>(clip(v) * 4294967296.0f);
+}
+
+float Envelope::AttackParam::get() {
+  return static_cast<float>(LOAD(envelope->attack)) / 4294967296.0f;
+}
@@ -0,0 +1,30 @@
+
+#include "cosas/crossfade.h"
+
+
+void Crossfade::start() {
+  count = 0;
+  weight = 0;
+}
+
+bool Crossfade::active() const {
+  return count < LENGTH;
+}
+
+int16_t Crossfade::mix(const int16_t outgoing, const int16_t incoming) {
+  if (!active()) return incoming;
+  if (!(count & ((1 << BLOCK_BITS) - 1))) {
+    // start of block, so weight steps from 0 to almost one14
+    weight = static_cast<uint16_t>((count >> BLOCK_BITS) << (one14_bits - N_BLOCKS_BITS));
+  }
+  count++;
+  const int32_t acc = weight * static_cast<int32_t>(incoming) + (one14 - weight) * static_cast<int32_t>(outgoing);
+  return clip_16(acc >> one14_bits);
+}
+
+int16_t Crossfade::next(const SourcePair& pair) {
+  const int16_t in = pair.incoming ? pair.incoming->next(0) : 0;
+  if (!active()) return in;
+  const int16_t out = pair.outgoing ? pair.outgoing->next(0) : 0;
+  return mix(out, in);
+}
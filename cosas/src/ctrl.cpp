@@ -27,14 +27,20 @@ std::ostream& operator<<(std::ostream& os, const CtrlEvent& obj) {
 void CtrlQueue::add(CtrlEvent event) {
   empty_ = false;
   if (event.ctrl == CtrlEvent::Switch) {
+    for (size_t i = 0; i < N_KNOBS; i++) {
+      if (queue[i].ctrl != CtrlEvent::Dummy && queue[i].ctrl != CtrlEvent::Switch) dropped++;
+    }
     queue[0] = event;
     queue[1] = CtrlEvent();
     queue[2] = CtrlEvent();
-  } else if (event.ctrl != CtrlEvent::Dummy && queue[0].ctrl != CtrlEvent::Switch) {
-    if (queue[event.ctrl].ctrl == CtrlEvent::Dummy) {
+  } else if (event.ctrl != CtrlEvent::Dummy) {
+    if (queue[0].ctrl == CtrlEvent::Switch) {
+      dropped++;
+    } else if (queue[event.ctrl].ctrl == CtrlEvent::Dummy) {
       queue[event.ctrl] = event;
     } else {
       queue[event.ctrl].now = event.now;
+      coalesced++;
     }
   }
 }
@@ -60,3 +66,64 @@ CtrlEvent CtrlQueue::pop() {
   offset = (offset + 1) % N_KNOBS;
   return found;
 }
+
+
+CtrlRing::CtrlRing() {
+  // cannot be set directly as may be atomic
+  head = 0;
+  tail = 0;
+}
+
+bool CtrlRing::push(CtrlEvent event) {
+  return publish(&event);
+}
+
+bool CtrlRing::flush() {
+  if (overflow.empty()) return false;
+  return publish(nullptr);
+}
+
+bool CtrlRing::publish(CtrlEvent* event) {
+  const uint32_t start = LOAD(head);
+  uint32_t h = start;
+  const uint32_t t = LOAD(tail);
+  // anything that spilled earlier goes first
+  while (!overflow.empty() && h - t < SIZE) {
+    CtrlEvent spilled = overflow.pop();
+    if (spilled.ctrl != CtrlEvent::Dummy) ring[h++ & MASK] = spilled.pack();
+  }
+  if (event) {
+    if (overflow.empty() && h - t < SIZE) {
+      ring[h++ & MASK] = event->pack();
+    } else {
+      overflow.add(*event);
+    }
+  }
+  if (h == start) return false;
+  head = h;
+  // if the consumer had taken everything before we published then it may
+  // be waiting (if it had not then it will see the new events anyway).
+  return LOAD(tail) == start;
+}
+
+void CtrlRing::drain() {
+  const uint32_t h = LOAD(head);
+  uint32_t t = LOAD(tail);
+  while (t != h) pending.add(CtrlEvent::unpack(ring[t++ & MASK]));
+  tail = t;
+}
+
+bool CtrlRing::pop(CtrlEvent& event) {
+  drain();
+  if (pending.empty()) return false;
+  event = pending.pop();
+  return event.ctrl != CtrlEvent::Dummy;
+}
+
+uint32_t CtrlRing::get_drops() const {
+  return overflow.dropped + pending.dropped;
+}
+
+uint32_t CtrlRing::get_coalesces() const {
+  return overflow.coalesced + pending.coalesced;
+}
@@ -15,6 +15,8 @@ void BaseManager::clear_all() {
   current_sources->clear();
   current_params->clear();
   current_panes->clear();
+  footprint = 0;
+  clock = Clock();
 }
 
 Pane& BaseManager::get_pane(size_t n) const {
@@ -25,6 +27,41 @@ size_t BaseManager::n_panes() const {
   return current_panes->size();
 }
 
+size_t BaseManager::get_footprint() const {
+  return footprint + n_panes() * sizeof(Pane);
+}
+
+EvalStats BaseManager::get_eval_stats() const {
+  EvalStats stats;
+  stats.frames = clock.get();
+  for (const std::unique_ptr<RelSource>& source : *current_sources) {
+    if (auto* o = dynamic_cast<BaseOscillator*>(source.get())) {
+      stats.evals += o->get_evals();
+      stats.repeats += o->get_repeats();
+    } else if (auto* s = dynamic_cast<Shared*>(source.get())) {
+      stats.shared_hits += s->get_hits();
+    }
+  }
+  return stats;
+}
+
+// the root of every engine, so that time advances once per sample
+RelSource& BaseManager::add_frame(RelSource& root) {
+  return add_source<Frame>(root, clock);
+}
+
+// insert a Decimated if src is control rate (so that it is called once
+// per block and interpolated for an audio rate consumer)
+RelSource& BaseManager::at_audio_rate(RelSource& src, bool hold) {
+  if (!src.rate_bits()) return src;
+  return add_source<Decimated>(src, hold);
+}
+
+// for nodes with more than one consumer
+RelSource& BaseManager::add_shared(RelSource& src) {
+  return add_source<Shared>(src, clock);
+}
+
 Pane& BaseManager::add_pane(Param& main, Param& x, Param& y) const {
   std::unique_ptr<Pane> pane = std::make_unique<Pane>(main, x, y);
   current_panes->push_back(std::move(pane));
@@ -104,15 +141,40 @@ BaseManager::add_rel_poly_osc_w_gain(AbsFreqParam& frq, size_t shp, size_t asym,
   return {g, o};
 }
 
+// panes:
+//   1 - rate/shp/gain
+std::tuple<Gain&, Lfo&> BaseManager::add_lfo_w_gain(const float hz, const Lfo::Shape shape, const float amp) {
+  Lfo& l = add_source<Lfo>(hz, shape);
+  Gain& g = add_source<Gain>(l, amp, true);
+  add_pane(l.get_rate_param(), l.get_shape_param(), g.get_amp(), l);
+  return {g, l};
+}
+
+// panes:
+//   1 - rate/att/blk
+Envelope& BaseManager::add_envelope(const float hz, const float attack) {
+  Envelope& e = add_source<Envelope>(hz, attack);
+  add_pane(e.get_rate_param(), e.get_attack_param(), add_param<Blank>(), e);
+  return e;
+}
+
+// if both inputs are control rate then so is the result
 Merge& BaseManager::add_balance(RelSource& a, RelSource& b, float bal) {
-  auto& m = add_source<Merge>(a, bal);
-  m.add_source(b, 1);
+  const bool audio = !a.rate_bits() || !b.rate_bits();
+  auto& m = add_source<Merge>(audio ? at_audio_rate(a) : a, bal);
+  m.add_source(audio ? at_audio_rate(b) : b, 1);
   return m;
 }
 
+AM& BaseManager::add_am(RelSource& a, RelSource& b) {
+  const bool audio = !a.rate_bits() || !b.rate_bits();
+  return add_source<AM>(audio ? at_audio_rate(a) : a, audio ? at_audio_rate(b) : b);
+}
+
 Mix& BaseManager::add_fm(RelSource& c, RelSource& m, float bal) {
-  Mix& b = add_source<Mix>(c, bal);
-  FM& fm = add_source<FM>(c, m);
+  RelSource& sc = add_shared(c);  // carrier is both dry and modulated
+  Mix& b = add_source<Mix>(sc, bal);
+  FM& fm = add_source<FM>(sc, at_audio_rate(m));
   b.set_wet(&fm);
   return b;
 }
@@ -126,9 +188,10 @@ RelSource& BaseManager::add_fm(RelSource& c, RelSource& m, float bal, float amp)
 // panes:
 //   1 - gain/wet/arg
 RelSource& BaseManager::add_fm(RelSource& c, RelSource& m, float bal, float amp, Param& right) {
-  Gain& g = add_source<Gain>(m, amp, 100);  // todo - hi
-  FM& fm = add_source<FM>(c, g);
-  Merge& b = add_balance(fm, c, bal);
+  Gain& g = add_source<Gain>(m, amp, 100);  // todo - hi (control rate if m is)
+  RelSource& sc = add_shared(c);  // carrier is both dry and modulated
+  FM& fm = add_source<FM>(sc, at_audio_rate(g));
+  Merge& b = add_balance(fm, sc, bal);
   add_pane(g.get_amp(), b.get_weight(0), right);
   return b;
 }
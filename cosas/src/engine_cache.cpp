@@ -0,0 +1,71 @@
+
+#include <stdexcept>
+
+#include "cosas/engine_cache.h"
+
+
+EngineCache::EngineCache(const size_t budget) : budget(budget) {};
+
+RelSource& EngineCache::select(SmallManager::SmallEngine engine) {
+  const size_t idx = engine < SmallManager::N_ENGINE ? engine : 0;
+  const size_t prev = active;
+  Entry& entry = entries[idx];
+  entry.stamp = ++clock;
+  if (entry.source) {
+    while (used > budget && evict_lru(idx, prev)) {}
+  } else {
+    // if we've seen this before, make space before building so that peak use
+    // stays within budget.  otherwise, tidy up afterwards.
+    while (used + entry.bytes > budget && evict_lru(idx, prev)) {}
+    entry.manager = std::make_unique<SmallManager>();
+    entry.source = &entry.manager->build(static_cast<SmallManager::SmallEngine>(idx));
+    entry.bytes = entry.manager->get_footprint();
+    used += entry.bytes;
+    builds++;
+    while (used > budget && evict_lru(idx, prev)) {}
+  }
+  active = idx;
+  return *entry.source;
+}
+
+SmallManager& EngineCache::get_manager() const {
+  if (active == SmallManager::N_ENGINE) throw std::logic_error("no engine selected");
+  return *entries[active].manager;
+}
+
+bool EngineCache::is_built(SmallManager::SmallEngine engine) const {
+  return engine < SmallManager::N_ENGINE && entries[engine].source;
+}
+
+size_t EngineCache::n_built() const {
+  size_t n = 0;
+  for (const Entry& entry : entries) if (entry.source) n++;
+  return n;
+}
+
+size_t EngineCache::get_used() const {
+  return used;
+}
+
+uint32_t EngineCache::get_builds() const {
+  return builds;
+}
+
+// discard the least recently used engine (other than keep and prev).
+// returns false if there was nothing to discard.
+bool EngineCache::evict_lru(const size_t keep, const size_t prev) {
+  Entry* lru = nullptr;
+  for (size_t i = 0; i < SmallManager::N_ENGINE; i++) {
+    Entry& entry = entries[i];
+    if (i != keep && i != prev && entry.source && (!lru || entry.stamp < lru->stamp)) lru = &entry;
+  }
+  if (!lru) return false;
+  discard(*lru);
+  return true;
+}
+
+void EngineCache::discard(Entry& entry) {
+  used -= entry.bytes;
+  entry.source = nullptr;
+  entry.manager.reset();  // bytes retained as estimate for next build
+}
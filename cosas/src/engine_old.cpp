@@ -5,15 +5,15 @@
 #include "cosas/engine_old.h"
 #include "cosas/modulators.h"
 
-constexpr int DEFAULT_BOXCAR = 1000;
-
 
 OldManager::OldManager() : wavelib(std::move(std::make_unique<Wavelib>())) {};
 
 RelSource& OldManager::build(OldManager::OldEngine engine) {
-
   clear_all();
+  return add_frame(build_engine(engine));
+}
 
+RelSource& OldManager::build_engine(OldManager::OldEngine engine) {
   switch (engine)
   {
   case OldManager::OldEngine::DEX:
@@ -70,6 +70,15 @@ RelSource& OldManager::add_rel_dex_osc(AbsFreqParam& root, size_t widx, float r,
   return o;
 }
 
+// panes:
+//   1 - freq/dex/det
+FbDexOsc& OldManager::add_fb_dex_osc(AbsFreqParam& root, size_t widx, float r, float d, float fb) {
+  auto& o = add_source<FbDexOsc>(*wavelib, widx, root, r, d, fb);
+  RelFreqParam& f = o.get_freq_param();
+  add_pane(root, o.get_dex_param(), f.get_det_param());
+  return o;
+}
+
 // panes:
 //   1 - freq/dex/blk
 RelSource& OldManager::build_dex() {
@@ -99,43 +108,39 @@ RelSource& OldManager::build_fm_simple() {
 // panes:
 //   1 - freq/dex/blk
 //   2 - freq/dex/det
-//   3 - freq/dex/blk
+//   3 - rate/shp/gain
 //   4 - gain/wet/blk
 RelSource& OldManager::build_fm_lfo() {
   auto [cf, c] = add_abs_dex_osc(440, wavelib->sine_gamma_1);
   RelSource& m = add_rel_dex_osc(cf, wavelib->sine_gamma_1, 1, 1);
-  auto [lf, l] = add_abs_dex_osc_w_gain(1, wavelib->sine_gamma_1, 1);
-  RelSource& am = add_source<AM>(l, m);
+  auto [l, lfo] = add_lfo_w_gain(1, Lfo::SINE, 1);
+  RelSource& am = add_am(l, m);
   RelSource& fm = add_fm(c, am, 0.5, 1.0 / (1 << (PHI_FUDGE_BITS - 4)));
   return fm;
 }
 
 // panes:
-//   1 - freq/dex/freq
+//   1 - freq/dex/rate
 //   2 - freq/dex/det
 //   3 - gain/wet/blk
-//   4 - off/shp/asym
+//   4 - rate/att/blk
 RelSource& OldManager::build_fm_env() {
   RelSource& fm = build_fm_simple();
-  AbsPolyOsc& e = add_abs_poly_osc(1, PolyTable::LINEAR - 1, 0, static_cast<size_t>(0.1f * QUARTER_TABLE_SIZE));
-  RelSource& am = add_source<AM>(e, fm);
-  dynamic_cast<Blank&>(get_pane(0).y).unblank(&e.get_freq_param());
+  Envelope& e = add_envelope(1, 0.05f);
+  RelSource& am = add_am(e, fm);
+  dynamic_cast<Blank&>(get_pane(0).y).unblank(&e.get_rate_param());
   return am;
 }
 
 // panes:
-//   1 - freq/dex/len
+//   1 - freq/dex/blk
 //   2 - freq/dex/det
 //   3 - gain/wet/fb
 RelSource& OldManager::build_fm_fb() {
-  auto& latch = add_source<Latch>();
-  auto& flt = add_source<Boxcar>(latch, DEFAULT_BOXCAR);
-  auto [cf, c] = add_abs_dex_osc(440, wavelib->sine_gamma_1, flt.get_len());
-  RelSource& m = add_rel_dex_osc(cf, wavelib->sine_gamma_1, 1, 1);
-  Merge& mrg = add_balance(flt, m, 0.5);
-  RelSource& fm = add_fm(c, mrg, 0.5, 1.0 / (1 << (PHI_FUDGE_BITS - 4)), mrg.get_weight(0));
-  latch.set_source(&fm);
-  return latch;
+  auto [cf, c] = add_abs_dex_osc(440, wavelib->sine_gamma_1);
+  FbDexOsc& m = add_fb_dex_osc(cf, wavelib->sine_gamma_1, 1, 1, 0.5);
+  RelSource& fm = add_fm(c, m, 0.5, 1.0 / (1 << (PHI_FUDGE_BITS - 4)), m.get_fb_param());
+  return fm;
 }
 
 // panes:
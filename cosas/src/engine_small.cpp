@@ -7,12 +7,20 @@
 
 RelSource& SmallManager::build(SmallEngine engine) {
   clear_all();
+  return add_frame(build_engine(engine));
+}
+
+RelSource& SmallManager::build_engine(SmallEngine engine) {
   switch (engine) {
   default:
   case OSCILLATOR:
     return build_oscillator();
   case SIMPLE_2_OSC_FM:
     return build_simple_2_osc_fm();
+  case FM_4_OP:
+    return build_fm_4_op();
+  case FM_6_OP:
+    return build_fm_6_op();
   }
 }
 
@@ -38,3 +46,33 @@ RelSource& SmallManager::build_simple_2_osc_fm() {
   return fm;
 }
 
+// panes:
+//   1 - freq/alg/gain
+//   2.. - ratio/level/fb (one per operator, from the carrier up)
+RelSource& SmallManager::add_operators(size_t n, size_t alg, std::span<const float> ratios, std::span<const float> levels) {
+  auto& o = add_source<Operators>(n, 440, alg, ratios, levels, 0.25f);
+  Gain& g = add_source<Gain>(o, 1.0f, false);
+  add_pane(o.get_freq_param(), o.get_alg_param(), g.get_amp(), o);
+  for (size_t i = 0; i < o.n_ops(); i++) {
+    add_pane(o.get_ratio_param(i), o.get_level_param(i), o.get_fb_param(i), o);
+  }
+  return g;
+}
+
+// panes:
+//   1 - freq/alg/gain
+//   2-5 - ratio/level/fb
+RelSource& SmallManager::build_fm_4_op() {
+  static constexpr std::array<float, 4> ratios = {1, 1, 2, 3};
+  static constexpr std::array<float, 4> levels = {1, 0.5f, 0.3f, 0.2f};
+  return add_operators(4, 0, ratios, levels);
+}
+
+// panes:
+//   1 - freq/alg/gain
+//   2-7 - ratio/level/fb
+RelSource& SmallManager::build_fm_6_op() {
+  static constexpr std::array<float, 6> ratios = {1, 1, 2, 1, 3, 1};
+  static constexpr std::array<float, 6> levels = {1, 0.5f, 0.3f, 0.7f, 0.3f, 0.2f};
+  return add_operators(6, 1, ratios, levels);
+}
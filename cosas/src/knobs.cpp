@@ -1,25 +1,35 @@
 
+#include <algorithm>
 #include <cmath>
-#include <iostream>
+#include <numbers>
 
 #include "cosas/knobs.h"
 #include "cosas/debug.h"
 
 
+KnobChange::KnobChange(KnobHandler *k, const uint16_t p, const Highlight h)
+  : position(p), normalized(static_cast<float>(p) / KnobHandler::ONE), highlight(h), knob(k) {};
+
 KnobChange::~KnobChange() {
   knob->apply_change();
 }
 
 
+KnobHandler::KnobHandler(float s, float ln, bool lg, float lo, float hi)
+  : scale(static_cast<int32_t>(s * (1 << COEFF_BITS))),
+    cubic(static_cast<int32_t>(4 * (1 - ln) * (1 << COEFF_BITS))),
+    linear(static_cast<int32_t>(ln * (1 << COEFF_BITS))),
+    log(lg), lo(lo), hi(hi) {};
+
 KnobChange KnobHandler::handle_knob_change(uint16_t now, uint16_t prev) {
-  normalized = sigmoid(now, prev);
-  return KnobChange(this, normalized, ends());
+  position = sigmoid(now, prev);
+  return KnobChange(this, static_cast<uint16_t>(position), ends());
 }
 
 KnobChange::Highlight KnobHandler::ends() {
   KnobChange::Highlight highlight = KnobChange::No;
-  if (normalized < 0.1f || normalized > 0.9f) highlight = KnobChange::Near;
-  if (normalized < 0.01f || normalized > 0.99f) highlight = KnobChange::Yes;
+  if (position < ONE / 10 || position > ONE - ONE / 10) highlight = KnobChange::Near;
+  if (position < ONE / 100 || position > ONE - ONE / 100) highlight = KnobChange::Yes;
   return highlight;
 }
 
@@ -27,17 +37,28 @@ bool KnobHandler::is_valid() {
   return valid;
 }
 
-float KnobHandler::clip(float n) {
+int32_t KnobHandler::clip(int32_t p) {
   // aiming for [0, 1) here
-  return std::max(0.0f, std::min(0.999999f, n));
+  return std::max(0, std::min(ONE - 1, p));
+}
+
+// 4 * (1 - linearity) * x^3 + linearity * x for x = (adc - 2048) / 4095,
+// without the constant 0.5 (which cancels).  x is POSITION_BITS fixed point
+// (|x| <= 0.5, and 16388 / 1024 is 65536 / 4095 to 6 figures).  x^3 keeps
+// 2 extra bits (and rounds) since the cubic coefficient can be 4.  all
+// products fit in 32 bits.
+
+int32_t KnobHandler::response(uint16_t adc) const {
+  constexpr int32_t half = 1 << 14;
+  const int32_t x = ((static_cast<int32_t>(adc) - 2048) * 16388) >> 10;
+  const int32_t x2 = (x * x + half) >> 15;
+  const int32_t x3 = (x2 * x + half) >> 15;
+  return (cubic * x3 + (linear * x << 2) + (1 << (COEFF_BITS + 1))) >> (COEFF_BITS + 2);
 }
 
-float KnobHandler::sigmoid(uint16_t now, uint16_t prev) {
-  float x1 = static_cast<float>(now - 2048) / 4095;
-  float x0 = static_cast<float>(prev - 2048) / 4095;
-  float y1 =  4.0f * (1.0f - linearity) * powf(x1, 3.0f) + linearity * x1 + 0.5f;
-  float y0 =  4.0f * (1.0f - linearity) * powf(x0, 3.0f) + linearity * x0 + 0.5f;
-  return clip(normalized + scale * (y1 - y0));
+int32_t KnobHandler::sigmoid(uint16_t now, uint16_t prev) {
+  const int64_t delta = response(now) - response(prev);
+  return clip(position + static_cast<int32_t>((scale * delta) >> COEFF_BITS));
 }
 
 
@@ -48,17 +69,43 @@ ParamAdapter::ParamAdapter(Param &p)
     float v = p.get();
     if (p.log) v = log10f(v);
     v = (v - p.lo) / (p.hi - p.lo);
-    normalized = clip(v);
+    position = clip(static_cast<int32_t>(std::max(0.0f, v) * ONE));
+    if (log) {
+      base = powf(10, lo);
+      octaves = static_cast<int32_t>((hi - lo) * std::numbers::log2e_v<float> * std::numbers::ln10_v<float> * ONE);
+    }
   } else {
-    normalized = 0;
+    position = 0;
   }
 }
 
+// 2^(i / 2^EXP_BITS) with 30 fractional bits
+
+const ParamAdapter::ExpTable& ParamAdapter::exp2_table() {
+  static ExpTable table = [] {
+    ExpTable t{};
+    for (size_t i = 0; i < t.size(); i++) {
+      t[i] = static_cast<uint32_t>(std::round(std::exp2(static_cast<double>(i) / (1 << EXP_BITS)) * (1 << 30)));
+    }
+    return t;
+  }();
+  return table;
+}
+
 void ParamAdapter::apply_change() {
   if (valid) {
-    float val = lo + (hi - lo) * normalized;
-    if (log) val = powf(10, val);
-    param.set(val);
+    if (log) {
+      // 10^(lo + (hi - lo) * n) is 10^lo * 2^e with e in octaves (fixed point)
+      const int32_t e = static_cast<int32_t>((static_cast<int64_t>(octaves) * position) >> POSITION_BITS);
+      const int32_t whole = e >> POSITION_BITS;
+      const uint32_t frac = static_cast<uint32_t>(e) & (ONE - 1);
+      const ExpTable& t = exp2_table();
+      const uint32_t idx = frac >> (POSITION_BITS - EXP_BITS);
+      const uint32_t f = frac & ((1 << (POSITION_BITS - EXP_BITS)) - 1);
+      const uint32_t m = t[idx] + (((t[idx + 1] - t[idx]) * f) >> (POSITION_BITS - EXP_BITS));
+      param.set(base * ldexpf(static_cast<float>(m), whole - 30));
+    } else {
+      param.set(lo + (hi - lo) * static_cast<float>(position) / ONE);
+    }
   }
 }
-
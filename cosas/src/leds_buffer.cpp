@@ -1,41 +1,64 @@
 
+#include <algorithm>
+#include <cstdint>
+
 #include "cosas/leds_buffer.h"
 
 
+uint32_t BaseLEDsBuffer::frame(const Transition& t, const size_t s) const {
+  if (!t.interp || s >= INTERP_N) return t.to;
+  const uint8_t bits = leds_mask->BITS;
+  const uint32_t bits_mask = leds_mask->BITS_MASK;
+  uint32_t between = 0;
+  for (size_t led = 0; led < BaseLEDsMask::N; led++) {
+    const size_t shift = led * bits;
+    const uint32_t b0 = (t.from >> shift) & bits_mask;
+    const uint32_t b1 = (t.to >> shift) & bits_mask;
+    between |= (bits_mask & ((s * b1 + (INTERP_N - s) * b0) >> INTERP_BITS)) << shift;
+  }
+  return between;
+}
+
 void BaseLEDsBuffer::render() {
-  while (!buffer.empty()) {
-    auto next = buffer.front();
-    mask = std::get<0>(next);
-    leds_mask->show(mask);
-    buffer.pop();
-    if (std::get<1>(next)) return;
+  uint32_t r = read.load(std::memory_order_relaxed);
+  const uint32_t w = written.load(std::memory_order_acquire);
+  const uint32_t skip = skip_to.load(std::memory_order_relaxed);
+  // skip may be from a transition not yet published, so must also be before w
+  if (static_cast<int32_t>(skip - r) > 0 && static_cast<int32_t>(w - skip) > 0) {
+    r = skip;
+    step = 0;
   }
+  if (r == w) return;
+  uint32_t m = 0;
+  while (r != w) {
+    const Transition& t = ring[r & (CAPACITY - 1)];
+    m = frame(t, step);
+    if (step < t.steps) {
+      step++;
+      break;
+    }
+    step = 0;
+    r++;
+  }
+  mask.store(m, std::memory_order_relaxed);
+  read.store(r, std::memory_order_release);
+  leds_mask->show(m);
 }
 
-uint32_t BaseLEDsBuffer::get_mask() {return mask;}
+uint32_t BaseLEDsBuffer::get_mask() {return mask.load(std::memory_order_relaxed);}
 
-void BaseLEDsBuffer::queue(uint32_t mask_new, bool force, bool interp, size_t n) {
-  // TODO - lock buffer
+bool BaseLEDsBuffer::queue(uint32_t mask_new, bool force, bool interp, size_t n) {
   lazy_start_on_local_core();
-  if (buffer.empty() && !interp && !n && mask == mask_new) return;
-  if (force) std::queue<std::tuple<uint32_t, bool>>().swap(buffer);
-  if (interp) {
-    uint32_t mask_old = buffer.empty() ? mask : std::get<0>(buffer.back());
-    for (size_t weight = 0; weight < INTERP_N; weight++) {
-      uint32_t old = mask_old;
-      uint32_t new_ = mask_new;
-      uint32_t between = 0;
-      for (size_t led = 0; led < BaseLEDsMask::N; led++) {
-        uint32_t b0 = old & leds_mask->BITS_MASK;
-        uint32_t b1 = new_ & leds_mask->BITS_MASK;
-        between <<= leds_mask->BITS;
-        between |= leds_mask->BITS_MASK & ((weight * b1 + (INTERP_N - weight) * b0) >> INTERP_BITS);
-        old >>= leds_mask->BITS;
-        new_ >>= leds_mask->BITS;
-      }
-      buffer.push({leds_mask->reverse(between), true});
-    }
-  }
-  for (size_t i = 0; i < n; ++i) {buffer.push({mask_new, true});}
-  buffer.push({mask_new, false});
+  const uint32_t w = written.load(std::memory_order_relaxed);
+  const uint32_t r = read.load(std::memory_order_acquire);
+  const bool empty = force || r == w;
+  if (r == w && !interp && !n && get_mask() == mask_new) return true;
+  if (w - r == CAPACITY) return false;
+  const uint32_t from = empty ? get_mask() : last;
+  const size_t steps = std::min(static_cast<size_t>(UINT16_MAX), (interp ? INTERP_N : 0) + n);
+  ring[w & (CAPACITY - 1)] = {from, mask_new, static_cast<uint16_t>(steps), interp};
+  last = mask_new;
+  if (force) skip_to.store(w, std::memory_order_relaxed);
+  written.store(w + 1, std::memory_order_release);
+  return true;
 }
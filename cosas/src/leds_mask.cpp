@@ -47,6 +47,52 @@ uint32_t BaseLEDsMask::constant(uint8_t fg) {
 }
 
 uint32_t BaseLEDsMask::ring(float normalized, bool highlight) {
+  const float clipped = std::max(0.0f, std::min(1.0f, normalized));
+  return ring_fixed(static_cast<uint16_t>(clipped * (1 << RING_BITS) + 0.5f), highlight);
+}
+
+// positions are in units of 1/(1 << RING_BITS) of an led, so the float
+// version's window edges (multiples of 1/4 led) and overlaps are exact.
+
+uint32_t BaseLEDsMask::ring_fixed(uint16_t position, bool highlight) {
+  constexpr int32_t one = 1 << RING_BITS;
+  const int32_t centre = static_cast<int32_t>(std::min(position, static_cast<uint16_t>(one))) * static_cast<int32_t>(N);
+  uint32_t mask = 0;
+  mask = overwrite_fixed(mask, centre, 5 * one / 4, 0x07);
+  mask = overwrite_fixed(mask, centre, 3 * one / 4, 0x0f);
+  if (highlight) mask = overwrite_fixed(mask, centre, one / 2, 0x1f);
+  return mask;
+}
+
+uint32_t BaseLEDsMask::overwrite_fixed(uint32_t mask, int32_t centre, int32_t half_width, uint8_t amplitude) {
+  constexpr int32_t one = 1 << RING_BITS;
+  const int32_t win_lo = centre - half_width;
+  const int32_t win_hi = centre + half_width;
+  for (size_t led = 0; led < N; led++) {
+    const int32_t led_lo = static_cast<int32_t>(led) * one;
+    const int32_t led_hi = led_lo + one;
+    int32_t overlap;
+    if (win_lo < led_lo) {
+      overlap = win_hi > led_hi ? one : std::clamp(win_hi - led_lo, 0, one);
+    } else {
+      overlap = win_hi > led_hi ? std::clamp(led_hi - win_lo, 0, one) : std::min(one, 2 * half_width);
+    }
+    mask = update(mask, led, static_cast<uint8_t>((amplitude * overlap) >> RING_BITS) & 0x0f);
+  }
+  return mask;
+}
+
+uint32_t BaseLEDsMask::update(uint32_t mask, size_t led, uint8_t new_val) {
+  size_t shift = ring_order[led] * BITS;
+  uint8_t old_val = (mask >> shift) & BITS_MASK;
+  if (new_val > old_val) {
+    mask &= (FULL_MASK - (BITS_MASK << shift));
+    mask |= new_val << shift;
+  }
+  return mask;
+}
+
+uint32_t BaseLEDsMask::ring_float(float normalized, bool highlight) {
   uint32_t mask = 0;
   normalized *= N;
   mask = overwrite(mask, normalized, 2.5f, 0x07);
@@ -75,13 +121,7 @@ uint32_t BaseLEDsMask::overwrite(uint32_t mask, float centre, float width, uint8
         overlap = std::min(1.0f, width);
       }
     }
-    size_t shift = ring_order[led] * BITS;
-    uint8_t new_val = static_cast<uint8_t>(amplitude * overlap) & 0x0f;
-    uint8_t old_val = (mask >> shift) & BITS_MASK;
-    if (new_val > old_val) {
-      mask &= (FULL_MASK - (BITS_MASK << shift));
-      mask |= new_val << shift;
-    }
+    mask = update(mask, led, static_cast<uint8_t>(amplitude * overlap) & 0x0f);
   }
   return mask;
 }
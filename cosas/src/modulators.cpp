@@ -1,4 +1,6 @@
 
+#include <algorithm>
+
 #include "cosas/maths.h"
 #include "cosas/modulators.h"
 
@@ -11,6 +13,10 @@ int16_t FM::next(const int32_t phi) {
   return carrier.next(phi2);
 };
 
+uint8_t FM::rate_bits() const {
+  return std::min(carrier.rate_bits(), modulator.rate_bits());
+}
+
 
 AM::AM(RelSource& src1, RelSource& src2)
   : src1(src1), src2(src2) {};
@@ -21,3 +27,7 @@ int16_t AM::next(int32_t phi) {
   return clip_16((s1 * s2) >> 16);
 };
 
+uint8_t AM::rate_bits() const {
+  return std::min(src1.rate_bits(), src2.rate_bits());
+}
+
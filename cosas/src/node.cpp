@@ -48,3 +48,30 @@ SetOnInScope::SetOnInScope(Latch* l) : latch(l) {
 SetOnInScope::~SetOnInScope() {
   latch->on = false;
 }
+
+
+Shared::Shared(RelSource& src, Clock& clock) : src(src), clock(clock), stamp(clock.get() - 1) {};
+
+int16_t Shared::next(const int32_t phi) {
+  const uint32_t frame = clock.get();
+  if (frame == stamp && phi == cached_phi) {
+    hits++;
+  } else {
+    stamp = frame;
+    cached_phi = phi;
+    cached = src.next(phi);
+  }
+  return cached;
+}
+
+uint32_t Shared::get_hits() const {
+  return hits;
+}
+
+
+Frame::Frame(RelSource& src, Clock& clock) : src(src), clock(clock) {};
+
+int16_t Frame::next(const int32_t phi) {
+  clock.advance();
+  return src.next(phi);
+}
@@ -0,0 +1,39 @@
+
+#include <algorithm>
+#include <cmath>
+
+#include "cosas/maths.h"
+#include "cosas/noise.h"
+
+
+NoiseSource::NoiseSource(const uint8_t s, const uint32_t seed) : random(seed), smooth_param(this) {
+  smooth_param.set(s);
+}
+
+int16_t NoiseSource::next(int32_t /* phi */) {
+  const int32_t x = random.next_int12();
+  const uint8_t s = LOAD(smooth);
+  if (!s) return previous = static_cast<int16_t>(x);
+  state += ((x << FRAC_BITS) - state) >> s;
+  return previous = clip_16(((state >> 8) * LOAD(gain)) >> (FRAC_BITS - 8 + GAIN_BITS));
+}
+
+NoiseSource::SmoothParam& NoiseSource::get_smooth_param() {
+  return smooth_param;
+}
+
+
+NoiseSource::SmoothParam::SmoothParam(NoiseSource* n) : Param(1, 1, false, 0, MAX_SMOOTH), noise(n) {};
+
+// the filter scales variance by a / (2 - a) where a = 2^-smooth.
+void NoiseSource::SmoothParam::set(const float v) {
+  const auto s = static_cast<uint8_t>(std::min(static_cast<float>(MAX_SMOOTH), std::max(0.0f, v)));
+  const float a = 1.0f / static_cast<float>(1 << s);
+  const float g = sqrtf(3.0f * (2 - a) / a) / 3;
+  noise->gain = static_cast<int32_t>(g * (1 << GAIN_BITS));
+  noise->smooth = s;
+}
+
+float NoiseSource::SmoothParam::get() {
+  return LOAD(noise->smooth);
+}
@@ -0,0 +1,199 @@
+
+#include <algorithm>
+#include <bit>
+#include <numbers>
+#include <utility>
+
+#include "cosas/maths.h"
+#include "cosas/operators.h"
+
+
+// operator indices are 0 (bottom, always a carrier) to n-1 (top, feedback).
+// these are the classic 4 operator set (4 -> 3 -> 2 -> 1 is alg 0 here).
+
+const std::array<Operators::Algorithm, Operators::N_ALGORITHMS> Operators::ALGORITHMS_4 = {{
+  {{0b0010, 0b0100, 0b1000, 0, 0, 0}, 0b0001},  // 3 -> 2 -> 1 -> 0
+  {{0b0010, 0b1100, 0, 0, 0, 0}, 0b0001},  // (3 + 2) -> 1 -> 0
+  {{0b1010, 0b0100, 0, 0, 0, 0}, 0b0001},  // (3 + (2 -> 1)) -> 0
+  {{0b0110, 0, 0b1000, 0, 0, 0}, 0b0001},  // ((3 -> 2) + 1) -> 0
+  {{0b0010, 0, 0b1000, 0, 0, 0}, 0b0101},  // 3 -> 2, 1 -> 0
+  {{0b1000, 0b1000, 0b1000, 0, 0, 0}, 0b0111},  // 3 -> (2, 1, 0)
+  {{0, 0, 0b1000, 0, 0, 0}, 0b0111},  // 3 -> 2, 1, 0
+  {{0, 0, 0, 0, 0, 0}, 0b1111}  // additive
+}};
+
+const std::array<Operators::Algorithm, Operators::N_ALGORITHMS> Operators::ALGORITHMS_6 = {{
+  {{0b000010, 0b000100, 0b001000, 0b010000, 0b100000, 0}, 0b000001},  // 5 -> 4 -> 3 -> 2 -> 1 -> 0
+  {{0b000010, 0, 0b001000, 0b010000, 0b100000, 0}, 0b000101},  // 5 -> 4 -> 3 -> 2, 1 -> 0
+  {{0b000010, 0b000100, 0, 0b010000, 0b100000, 0}, 0b001001},  // 5 -> 4 -> 3, 2 -> 1 -> 0
+  {{0b001010, 0b000100, 0, 0b010000, 0b100000, 0}, 0b000001},  // ((5 -> 4 -> 3) + (2 -> 1)) -> 0
+  {{0b000010, 0, 0b001000, 0, 0b100000, 0}, 0b010101},  // 5 -> 4, 3 -> 2, 1 -> 0
+  {{0b000010, 0, 0b100000, 0b100000, 0b100000, 0}, 0b011101},  // 5 -> (4, 3, 2), 1 -> 0
+  {{0, 0, 0, 0, 0b100000, 0}, 0b011111},  // 5 -> 4, 3, 2, 1, 0
+  {{0, 0, 0, 0, 0, 0}, 0b111111}  // additive
+}};
+
+
+template<typename P, size_t... I>
+static std::array<P, sizeof...(I)> make_params(Operators* o, std::index_sequence<I...>) {
+  return {P(o, I)...};
+}
+
+Operators::Operators(const size_t n, const float hz, const size_t alg,
+                     const std::span<const float> ratios, const std::span<const float> levels, const float fb)
+  : n(std::min(n, MAX_OPS)), algorithms(n > 4 ? std::span(ALGORITHMS_6) : std::span(ALGORITHMS_4)), sines(sine_table()),
+    freq_param(this), alg_param(this),
+    ratio_params(make_params<RatioParam>(this, std::make_index_sequence<MAX_OPS>())),
+    level_params(make_params<LevelParam>(this, std::make_index_sequence<MAX_OPS>())),
+    fb_params(make_params<FeedbackParam>(this, std::make_index_sequence<MAX_OPS>())) {
+  // cannot be set directly as may be atomic
+  root = 0;
+  for (size_t i = 0; i < MAX_OPS; i++) {
+    delta[i] = 0;
+    level[i] = 0;
+    feedback[i] = 0;
+    ratio[i] = 1;
+  }
+  alg_param.set(static_cast<float>(alg));
+  for (size_t i = 0; i < this->n; i++) {
+    ratio_params[i].set(i < ratios.size() ? ratios[i] : 1);
+    level_params[i].set(i < levels.size() ? levels[i] : 0);
+  }
+  fb_params[this->n - 1].set(fb);
+  freq_param.set(hz);
+}
+
+const Operators::Table& Operators::sine_table() {
+  static Table table = [] {
+    Table t{};
+    for (size_t i = 0; i < t.size(); i++) {
+      t[i] = static_cast<int16_t>(roundf(SAMPLE_MAX * sinf(2 * std::numbers::pi_v<float> * static_cast<float>(i) / (1 << SINE_BITS))));
+    }
+    return t;
+  }();
+  return table;
+}
+
+int16_t Operators::sine(const Table& t, const uint32_t phase) {
+  const uint32_t idx = phase >> (32 - SINE_BITS);
+  const int32_t frac = static_cast<int32_t>((phase >> (16 - SINE_BITS)) & 0xffff);
+  return static_cast<int16_t>(t[idx] + (((t[idx + 1] - t[idx]) * frac) >> 16));
+}
+
+int16_t Operators::next(const int32_t phi) {
+  static constexpr std::array<int32_t, MAX_OPS + 1> inverse = {0, 1 << 16, 1 << 15, 21845, 1 << 14, 13107, 10923};
+  const Algorithm& alg = algorithms[LOAD(algorithm)];
+  // top down, so modulators are always ready
+  for (size_t i = n; i-- > 0; ) {
+    const uint32_t d = LOAD(delta[i]);
+    phase[i] += d;
+    uint32_t p = phase[i];
+    if (phi) p += static_cast<uint32_t>((static_cast<int64_t>(phi) * d) >> PHI_FUDGE_BITS_2);  // as BaseOscillator
+    int32_t mod = 0;
+    for (uint8_t m = alg.mods[i]; m; m &= m - 1) mod += out[std::countr_zero(m)];
+    p += static_cast<uint32_t>(mod) << MOD_BITS;
+    const int32_t fb = ((out[i] + prev[i]) * LOAD(feedback[i])) >> ONE_BITS;  // twice the average
+    p += static_cast<uint32_t>(fb) << (FB_BITS - 1);
+    prev[i] = out[i];
+    out[i] = static_cast<int16_t>((sine(sines, p) * LOAD(level[i])) >> ONE_BITS);
+  }
+  int32_t sum = 0;
+  for (uint8_t c = alg.carriers; c; c &= c - 1) sum += out[std::countr_zero(c)];
+  return previous = static_cast<int16_t>((sum * inverse[std::popcount(alg.carriers)]) >> 16);
+}
+
+size_t Operators::n_ops() const {
+  return n;
+}
+
+void Operators::recalculate(const size_t i) {
+  const float d = static_cast<float>(LOAD(root)) * ratio[i];
+  delta[i] = static_cast<uint32_t>(std::min(2147483648.0f, d));  // nyquist
+}
+
+Operators::FreqParam& Operators::get_freq_param() {
+  return freq_param;
+}
+
+Operators::AlgorithmParam& Operators::get_alg_param() {
+  return alg_param;
+}
+
+Operators::RatioParam& Operators::get_ratio_param(const size_t i) {
+  return ratio_params[i];
+}
+
+Operators::LevelParam& Operators::get_level_param(const size_t i) {
+  return level_params[i];
+}
+
+Operators::FeedbackParam& Operators::get_fb_param(const size_t i) {
+  return fb_params[i];
+}
+
+
+// same range as FrequencyParam
+
+Operators::FreqParam::FreqParam(Operators* o)
+  : Param(0.5, 0, true, log10f(1.0 / (1 << SUBTICK_BITS)), log10f(0.5 * SAMPLE_RATE)), ops(o) {};
+
+void Operators::FreqParam::set(const float hz) {
+  ops->root = static_cast<uint32_t>(clip(hz) / static_cast<float>(SAMPLE_RATE) * 4294967296.0f);
+  for (size_t i = 0; i < ops->n; i++) ops->recalculate(i);
+}
+
+float Operators::FreqParam::get() {
+  return static_cast<float>(LOAD(ops->root)) / 4294967296.0f * static_cast<float>(SAMPLE_RATE);
+}
+
+
+Operators::AlgorithmParam::AlgorithmParam(Operators* o) : Param(1, 1, false, 0, N_ALGORITHMS - 1), ops(o) {};
+
+void Operators::AlgorithmParam::set(const float v) {
+  ops->algorithm = static_cast<uint8_t>(std::min(static_cast<float>(N_ALGORITHMS - 1), std::max(0.0f, v)));
+}
+
+float Operators::AlgorithmParam::get() {
+  return LOAD(ops->algorithm);
+}
+
+
+Operators::OpParam::OpParam(Operators* o, const size_t i, float scale, float linearity, bool log, float lo, float hi)
+  : Param(scale, linearity, log, lo, hi), ops(o), idx(i) {};
+
+
+// ratios are rounded to simple fractions (as RelFreqParam)
+
+Operators::RatioParam::RatioParam(Operators* o, const size_t i)
+  : OpParam(o, i, 1, 0, true, log10f(0.125f), log10f(16)) {};
+
+void Operators::RatioParam::set(const float v) {
+  ops->ratio[idx] = SimpleRatio(clip(v)).as_float();
+  ops->recalculate(idx);
+}
+
+float Operators::RatioParam::get() {
+  return ops->ratio[idx];
+}
+
+
+Operators::LevelParam::LevelParam(Operators* o, const size_t i) : OpParam(o, i, 1, 1, false, 0, 1) {};
+
+void Operators::LevelParam::set(const float v) {
+  ops->level[idx] = static_cast<int32_t>(clip(v) * (1 << ONE_BITS));
+}
+
+float Operators::LevelParam::get() {
+  return static_cast<float>(LOAD(ops->level[idx])) / (1 << ONE_BITS);
+}
+
+
+Operators::FeedbackParam::FeedbackParam(Operators* o, const size_t i) : OpParam(o, i, 1, 1, false, 0, 1) {};
+
+void Operators::FeedbackParam::set(const float v) {
+  ops->feedback[idx] = static_cast<int32_t>(clip(v) * (1 << ONE_BITS));
+}
+
+float Operators::FeedbackParam::get() {
+  return static_cast<float>(LOAD(ops->feedback[idx])) / (1 << ONE_BITS);
+}
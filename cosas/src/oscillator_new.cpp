@@ -1,9 +1,167 @@
 
+#include <algorithm>
 #include <iostream>
 
 #include "cosas/constants.h"
 #include "cosas/debug.h"
 #include "cosas/engine_old.h"
+#include "cosas/maths.h"
 #include "cosas/oscillator_old.h"
 
 
+
+
+FbDexOsc::FbDexOsc(Wavelib& wl, size_t widx, AbsFreqParam& root, float f, float d, float fb)
+  : BaseOscillator(0, &wl[widx]), WavedexMixin(this, wl), freq_param(RelFreqParam(this, root, f, d)),
+    fb_param(this) {
+  root.add_relative_freq(&this->get_freq_param());
+  get_freq_param().set(f);  // push initial value
+  fb_param.set(fb);
+}
+
+int16_t FbDexOsc::next(const int32_t phi) {
+  const int32_t fb = ((y1 + y2) * LOAD(feedback)) >> (FB_BITS + 1);  // +1 for average
+  const int16_t y = BaseOscillator::next(phi + fb);
+  y2 = y1;
+  y1 = y;
+  return y;
+}
+
+RelFreqParam& FbDexOsc::get_freq_param() {
+  return freq_param;
+}
+
+FbDexOsc::FeedbackParam& FbDexOsc::get_fb_param() {
+  return fb_param;
+}
+
+
+FbDexOsc::FeedbackParam::FeedbackParam(FbDexOsc* o) : Param(1, 1, false, 0, 1), oscillator(o) {};
+
+void FbDexOsc::FeedbackParam::set(const float v) {
+  oscillator->feedback = static_cast<int32_t>(clip(v) * (1 << 16));
+}
+
+float FbDexOsc::FeedbackParam::get() {
+  return static_cast<float>(LOAD(oscillator->feedback)) / (1 << 16);
+}
+
+
+BlepOsc::BlepOsc(const float f) : BaseOscillator(hz2freq(f), nullptr), freq_param(AbsFreqParam(this, f)) {};
+
+int16_t BlepOsc::next(const int32_t phi) {
+  int32_t ticks = advance(phi) % TIME_MODULUS;
+  if (ticks < 0) ticks += TIME_MODULUS;
+  const int32_t y = at(to_phase(static_cast<uint32_t>(ticks)), to_phase(LOAD(frequency)));
+  return previous = clip_16((y * SAMPLE_MAX) >> AMP_BITS);
+}
+
+AbsFreqParam& BlepOsc::get_freq_param() {
+  return freq_param;
+}
+
+// a multiply rather than a division (rounded down so that a full cycle
+// stays below ONE)
+uint32_t BlepOsc::to_phase(const uint32_t ticks) {
+  static constexpr uint32_t scale = static_cast<uint32_t>((1ull << 32) / TIME_MODULUS);
+  return (ticks * scale) >> (32 - PHASE_BITS);
+}
+
+// polyblep: (1 - (1-t)/dt)^2 before, -(1 - t/dt)^2 after.  x is AMP scale.
+int32_t BlepOsc::blep(const uint32_t t, const uint32_t dt) {
+  if (t < dt) {
+    const auto x = static_cast<int32_t>(AMP - (t << AMP_BITS) / dt);
+    return -((x * x) >> AMP_BITS);
+  }
+  if (t > ONE - dt) {
+    const auto x = static_cast<int32_t>(AMP - ((ONE - t) << AMP_BITS) / dt);
+    return (x * x) >> AMP_BITS;
+  }
+  return 0;
+}
+
+// polyblamp (the integral of polyblep for a unit step): (1 - (1-t)/dt)^3 / 6
+// before, (1 - t/dt)^3 / 6 after.
+int32_t BlepOsc::blamp(const uint32_t t, const uint32_t dt) {
+  uint32_t u;
+  if (t < dt) u = t;
+  else if (t > ONE - dt) u = ONE - t;
+  else return 0;
+  const auto x = static_cast<int32_t>(AMP - (u << AMP_BITS) / dt);
+  return (((((x * x) >> AMP_BITS) * x) >> AMP_BITS) * 10923) >> 16;
+}
+
+
+BlepSquare::BlepSquare(const float f, const float d) : BlepOsc(f), duty_param(this) {
+  duty_param.set(d);
+}
+
+int32_t BlepSquare::at(const uint32_t t, const uint32_t dt) const {
+  const uint32_t d = LOAD(duty);
+  const int32_t y = t < d ? AMP : -AMP;
+  return y + blep(t, dt) - blep((t - d) & (ONE - 1), dt);
+}
+
+BlepSquare::DutyParam& BlepSquare::get_duty_param() {
+  return duty_param;
+}
+
+
+BlepSquare::DutyParam::DutyParam(BlepSquare* o) : Param(1, 1, false, 0, 1), oscillator(o) {};
+
+void BlepSquare::DutyParam::set(const float v) {
+  oscillator->duty = static_cast<uint32_t>(clip(v) * ONE);
+}
+
+float BlepSquare::DutyParam::get() {
+  return static_cast<float>(LOAD(oscillator->duty)) / ONE;
+}
+
+
+BlepSaw::BlepSaw(const float f, const float offset) : BlepOsc(f), offset_param(this) {
+  offset_param.set(offset);
+}
+
+int32_t BlepSaw::at(const uint32_t t, const uint32_t dt) const {
+  const uint32_t a = LOAD(peak);
+  const uint32_t w = ONE - 2 * a;
+  if (w < 2 * dt) {
+    // rising saw with a step down at 1/2
+    const auto y = static_cast<int32_t>(t < ONE / 2 ? t : t - ONE);
+    return y - blep((t - ONE / 2) & (ONE - 1), dt);
+  }
+  if (a < dt) {
+    // falling saw with a step up at 0
+    return AMP - static_cast<int32_t>(t) + blep(t, dt);
+  }
+  const uint32_t r = LOAD(rise), f = LOAD(fall);
+  int32_t y;
+  if (t < a) y = static_cast<int32_t>((t * r) >> 16);
+  else if (t < ONE - a) y = AMP - 2 * static_cast<int32_t>(((t - a) * f) >> 16);
+  else y = -AMP + static_cast<int32_t>(((t - (ONE - a)) * r) >> 16);
+  // change in slope per sample at the corners
+  const auto c = static_cast<int32_t>(((r * dt) >> 16) + ((f * dt) >> 15));
+  y -= (c * blamp((t - a) & (ONE - 1), dt)) >> AMP_BITS;
+  y += (c * blamp((t + a) & (ONE - 1), dt)) >> AMP_BITS;
+  return y;
+}
+
+BlepSaw::OffsetParam& BlepSaw::get_offset_param() {
+  return offset_param;
+}
+
+
+BlepSaw::OffsetParam::OffsetParam(BlepSaw* o) : Param(1, 1, false, -1, 1), oscillator(o) {};
+
+// peak at (1 + offset) / 4 of the cycle
+void BlepSaw::OffsetParam::set(const float v) {
+  const auto a = std::min(ONE / 2, static_cast<uint32_t>((1 + clip(v)) * ONE / 4));
+  const uint32_t w = ONE - 2 * a;
+  oscillator->peak = a;
+  oscillator->rise = a ? (1u << 31) / a : 0;
+  oscillator->fall = w ? (1u << 31) / w : 0;
+}
+
+float BlepSaw::OffsetParam::get() {
+  return static_cast<float>(LOAD(oscillator->peak)) * 4 / ONE - 1;
+}
@@ -14,6 +14,10 @@ BaseOscillator::BaseOscillator(uint32_t f, Wavetable* t) {
 };
 
 int16_t BaseOscillator::next(const int32_t phi) {
+  return previous = LOAD(abs_source)->next(advance(phi));
+}
+
+int32_t BaseOscillator::advance(const int32_t phi) {
   /*
    * the RelSource interface deals in delta samples - typically 1, but allowing
    * for more in case the output buffer underflows.  here we need to convert that
@@ -30,13 +34,33 @@ int16_t BaseOscillator::next(const int32_t phi) {
    * discard before calling the AbsSource interface.  so we can track time in
    * 32 bits after all.
    */
-  // increment time
+  // increment time (once per frame if we have a clock)
   uint32_t frequency_val = LOAD(frequency);
-  tick += static_cast<int32_t>(frequency_val);
-  if (tick > TIME_MODULUS) tick -= TIME_MODULUS;
+  evals++;
+  const uint32_t frame = clock ? clock->get() : stamp + 1;
+  if (frame != stamp) {
+    stamp = frame;
+    tick += static_cast<int32_t>(frequency_val);
+    if (tick > TIME_MODULUS) tick -= TIME_MODULUS;
+  } else {
+    repeats++;
+  }
   // convert phi to something like phase (didn't seem to get signed shift even though using c23)
   const int32_t phi_phase = sgn(phi) * static_cast<int32_t>((static_cast<uint32_t>(abs(phi)) * frequency_val) >> PHI_FUDGE_BITS_2);  // arbitrary scaling
-  return previous = LOAD(abs_source)->next(tick + phi_phase);
+  return tick + phi_phase;
+}
+
+void BaseOscillator::set_clock(Clock* c) {
+  clock = c;
+  if (clock) stamp = clock->get() - 1;
+}
+
+uint32_t BaseOscillator::get_evals() const {
+  return evals;
+}
+
+uint32_t BaseOscillator::get_repeats() const {
+  return repeats;
 }
 
 
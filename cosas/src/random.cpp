@@ -3,12 +3,22 @@
 
 #include "cosas/wavetable.h"
 
+#include <algorithm>
 #include <ctime>
 
 
 XorShift32::XorShift32(uint32_t s) : state(s), bit_index(0) {
   // autocomplete suggested this and it's not a bad idea (but is time available on pico?)
   if (!state) state = static_cast<uint32_t>(std::time(0));
+  // lanes are seeded with a hash (murmur3 finaliser) of state so that they
+  // are not just offsets along the same sequence
+  for (size_t i = 0; i < LANES; i++) {
+    uint32_t h = state + static_cast<uint32_t>(i) * 0x9e3779b9u;
+    h = (h ^ (h >> 16)) * 0x85ebca6bu;
+    h = (h ^ (h >> 13)) * 0xc2b2ae35u;
+    h ^= h >> 16;
+    lanes[i] = h ? h : 1;
+  }
   next_state();
 };
 
@@ -54,3 +64,34 @@ bool XorShift32::next_bool() {
   if (bit_index == 32) next_state();
   return state >> bit_index++ & 1;
 }
+
+// 16 random bits to SAMPLE_MIN..SAMPLE_MAX by multiplication (rather than
+// masking and rejecting -2048)
+int16_t XorShift32::scale_int12(const uint32_t val) {
+  return static_cast<int16_t>(static_cast<int32_t>(((val & 0xffff) * (2 * SAMPLE_MAX + 1)) >> 16) + SAMPLE_MIN);
+}
+
+// 2 * LANES values: low halves then high halves
+void XorShift32::fill_block(int16_t* out) {
+  for (size_t i = 0; i < LANES; i++) {
+    uint32_t x = lanes[i];
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    lanes[i] = x;
+    out[i] = scale_int12(x);
+    out[i + LANES] = scale_int12(x >> 16);
+  }
+}
+
+void XorShift32::fill(std::span<int16_t> out) {
+  constexpr size_t BLOCK = 2 * LANES;
+  size_t i = 0;
+  while (i < out.size() && spare_index < BLOCK) out[i++] = spare[spare_index++];
+  const size_t n = out.size() - (out.size() - i) % BLOCK;
+  for (; i < n; i += BLOCK) fill_block(out.data() + i);
+  if (i < out.size()) {
+    fill_block(spare.data());
+    for (spare_index = 0; i < out.size(); ) out[i++] = spare[spare_index++];
+  }
+}
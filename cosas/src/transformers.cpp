@@ -218,6 +218,12 @@ MergeFloat::Weight& MergeFloat::get_weight(size_t i) const {
   return weights->at(i);
 }
 
+uint8_t MergeFloat::rate_bits() const {
+  uint8_t bits = sources->front()->rate_bits();
+  for (const RelSource* s : *sources) bits = std::min(bits, s->rate_bits());
+  return bits;
+}
+
 int16_t MergeFloat::next(const int32_t phi) {
   float acc = 0;
   for (size_t i = 0; i < norm_weights->size(); i++) {
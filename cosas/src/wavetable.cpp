@@ -105,9 +105,8 @@ int16_t Saw::next(int32_t tick) const {
 }
 
 
-Noise::Noise(size_t smooth) {
-  std::random_device rd;
-  std::mt19937 gen(rd());
+Noise::Noise(size_t smooth, uint32_t seed) {
+  std::mt19937 gen(seed);
   std::uniform_int_distribution<> distrib(SAMPLE_MIN, SAMPLE_MAX);
   for (size_t i = 0; i < FULL_TABLE_SIZE; i++) {
     full_table.at(i) = distrib(gen);
@@ -167,8 +166,7 @@ void PolyTable::make_sine(std::array<int16_t, HALF_TABLE_SIZE>& table, size_t lo
 }
 
 void PolyTable::make_noise_std(std::array<int16_t, HALF_TABLE_SIZE>& table, size_t lo, size_t hi) {
-  std::random_device rd;
-  std::mt19937 gen(rd());
+  std::mt19937 gen(0);
   std::uniform_int_distribution<> distrib(SAMPLE_MIN, SAMPLE_MAX);
   for (size_t i = lo; i < hi; i++) table.at(i) = static_cast<int16_t>(SAMPLE_MAX * distrib(gen));
 }
@@ -0,0 +1,57 @@
+
+#include <cmath>
+#include <numbers>
+
+#include "doctest/doctest.h"
+
+#include "cosas/engine_small.h"
+#include "cosas/oscillator_new.h"
+#include "cosas/wavetable.h"
+
+#include "analysis.h"
+
+
+static double sine(double phase) {
+  return sin(2 * std::numbers::pi * phase);
+}
+
+
+TEST_CASE("Analysis, Sine") {
+  const Analysis a = analyse(render(Sine(), 440), 440, reference(sine, 440));
+  CHECK(a.thd_db < -60);
+  CHECK(a.alias_db < -60);
+  CHECK(a.noise_db < -60);
+  CHECK(a.snr_db > 60);  // 12 bits
+  CHECK(a.centroid == doctest::Approx(440).epsilon(0.05));
+}
+
+
+TEST_CASE("Analysis, Harmonics") {
+  // a square has odd harmonics at 1/k amplitude, so thd is about -6.8dB
+  const Analysis sq = analyse(render(Square(), 441), 441);
+  CHECK(sq.thd_db == doctest::Approx(-6.8).epsilon(0.1));
+  // quantisation shows as noise
+  const Analysis coarse = analyse(render(Sine(), 440), 440);
+  std::vector<int16_t> x = render(Sine(), 440);
+  for (int16_t& s : x) s = static_cast<int16_t>(s & ~0xff);
+  CHECK(analyse(x, 440).noise_db > coarse.noise_db + 20);
+}
+
+
+TEST_CASE("Analysis, Aliasing") {
+  // the naive square aliases badly at high frequencies; polyblep does not
+  BlepSquare blep = BlepSquare(3000, 0.5f);
+  const Analysis naive = analyse(render(Square(), 3000), 3000);
+  const Analysis smooth = analyse(render(blep), 3000);
+  MESSAGE("square alias " << naive.alias_db << " -> " << smooth.alias_db);
+  CHECK(naive.alias_db > -25);
+  CHECK(smooth.alias_db < naive.alias_db - 10);
+}
+
+
+TEST_CASE("Analysis, Engine") {
+  SmallManager m;
+  const Analysis a = analyse(render(m.build(SmallManager::OSCILLATOR)), 440);
+  CHECK(a.thd_db < -40);
+  CHECK(std::isnan(a.snr_db));
+}
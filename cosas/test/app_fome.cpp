@@ -6,7 +6,7 @@
 
 TEST_CASE("FomeApp, memory") {
   FomeApp app;
-  CHECK(app.n_sources() == 2);
+  CHECK(app.n_sources() == 4);
   RelSource* src = app.get_source(0);
   CHECK(src->next(0) == 128);
   CHECK(app.n_pages() == 2);
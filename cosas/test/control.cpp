@@ -0,0 +1,102 @@
+
+#include "doctest/doctest.h"
+
+#include "cosas/control.h"
+#include "cosas/modulators.h"
+#include "cosas/transformers.h"
+
+
+TEST_CASE("Control, interpolation") {
+  Lfo l = Lfo(100, Lfo::SAW);
+  Decimated d = Decimated(l, false);
+  int16_t prev = d.next(0);
+  for (uint32_t i = 1; i < CONTROL_N * 10; i++) {
+    int16_t s = d.next(0);
+    if (i > CONTROL_N) CHECK(s >= prev);  // rising, smoothly
+    CHECK(s - prev < 2 * SAMPLE_MAX * 100 / static_cast<int>(SAMPLE_RATE) + 2);
+    prev = s;
+  }
+}
+
+
+TEST_CASE("Control, LfoPeriod") {
+  Lfo l = Lfo(10, Lfo::SQUARE);
+  Decimated d = Decimated(l, true);
+  // count sign changes over a second
+  int16_t prev = d.next(0);
+  size_t changes = 0;
+  for (uint32_t i = 1; i < SAMPLE_RATE; i++) {
+    int16_t s = d.next(0);
+    if ((s < 0) != (prev < 0)) changes++;
+    prev = s;
+  }
+  CHECK(changes >= 19);
+  CHECK(changes <= 21);
+  CHECK(l.get_rate_param().get() == doctest::Approx(10).epsilon(0.01));
+}
+
+
+TEST_CASE("Control, LfoShapes") {
+  Lfo l = Lfo(1, Lfo::SINE);
+  Decimated d = Decimated(l, false);
+  for (size_t shape = 0; shape < Lfo::N_SHAPES; shape++) {
+    l.get_shape_param().set(static_cast<float>(shape));
+    int16_t lo = SAMPLE_MAX, hi = SAMPLE_MIN;
+    for (uint32_t i = 0; i < SAMPLE_RATE; i++) {
+      int16_t s = d.next(0);
+      lo = std::min(lo, s);
+      hi = std::max(hi, s);
+    }
+    CHECK(lo < SAMPLE_MIN + 100);
+    CHECK(hi > SAMPLE_MAX - 100);
+  }
+}
+
+
+TEST_CASE("Control, Envelope") {
+  Envelope e = Envelope(1, 0.1f);
+  Decimated d = Decimated(e, false);
+  int16_t peak = 0;
+  uint32_t peak_idx = 0;
+  for (uint32_t i = 0; i < SAMPLE_RATE; i++) {
+    int16_t s = d.next(0);
+    CHECK(s >= 0);
+    if (s > peak) {peak = s; peak_idx = i;}
+  }
+  CHECK(peak > SAMPLE_MAX - 10);
+  CHECK(peak_idx > SAMPLE_RATE / 10 - CONTROL_N * 2);
+  CHECK(peak_idx < SAMPLE_RATE / 10 + CONTROL_N * 2);
+}
+
+
+class Counted final : public RelSource {
+public:
+  int16_t next(int32_t /* phi */) override {return static_cast<int16_t>(1600 * ++calls);};
+  uint8_t rate_bits() const override {return CONTROL_BITS;};
+  int calls = 0;
+};
+
+
+TEST_CASE("Control, Rates") {
+  Lfo l = Lfo(1, Lfo::SINE);
+  Constant c = Constant(100);
+  Gain g = Gain(l, 1, true);
+  CHECK(g.rate_bits() == CONTROL_BITS);  // inherited
+  CHECK(AM(g, c).rate_bits() == 0);
+  CHECK(Decimated(g, false).rate_bits() == 0);
+}
+
+
+TEST_CASE("Control, Decimated") {
+  Counted c;
+  Decimated d = Decimated(c, false);
+  CHECK(d.next(0) == 0);
+  CHECK(d.next(0) == 1600 / CONTROL_N);
+  for (uint32_t i = 2; i < CONTROL_N; i++) (void)d.next(0);
+  CHECK(d.next(0) == 1600);
+  CHECK(c.calls == 2);  // one lookahead
+  Counted c2;
+  Decimated h = Decimated(c2, true);
+  CHECK(h.next(0) == 1600);
+  CHECK(h.next(0) == 1600);
+}
@@ -0,0 +1,44 @@
+
+#include "doctest/doctest.h"
+
+#include "cosas/crossfade.h"
+#include "cosas/node.h"
+
+
+TEST_CASE("Crossfade, inactive") {
+  Crossfade x;
+  CHECK_FALSE(x.active());
+  CHECK(x.mix(100, -100) == -100);
+}
+
+
+TEST_CASE("Crossfade, ramp") {
+  Crossfade x;
+  x.start();
+  int16_t prev = x.mix(1000, -1000);
+  CHECK(prev == 1000);
+  for (uint32_t i = 1; i < Crossfade::LENGTH; i++) {
+    int16_t s = x.mix(1000, -1000);
+    CHECK(s <= prev);  // monotonic
+    if (i & ((1 << Crossfade::BLOCK_BITS) - 1)) CHECK(s == prev);  // only changes per block
+    prev = s;
+  }
+  CHECK(prev < -900);
+  CHECK_FALSE(x.active());
+  CHECK(x.mix(1000, -1000) == -1000);
+}
+
+
+TEST_CASE("Crossfade, pair") {
+  Constant a = Constant(200);
+  Constant b = Constant(-200);
+  Crossfade x;
+  x.start();
+  SourcePair p = {&b, &a};
+  CHECK(x.next(p) == 200);
+  for (uint32_t i = 1; i < Crossfade::LENGTH; i++) x.next(p);
+  CHECK(x.next(p) == -200);
+  x.start();
+  p = {&b, nullptr};  // fade in from silence
+  CHECK(x.next(p) == 0);
+}
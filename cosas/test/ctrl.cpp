@@ -31,4 +31,84 @@ TEST_CASE("CtrlEvent, pack/unpack") {
     CHECK(event == CtrlEvent::unpack(event.pack()));
   };
   round_trip(CtrlEvent(1, 2, 3));
-}
\ No newline at end of file
+}
+TEST_CASE("CtrlQueue, counts") {
+  CtrlQueue queue;
+  queue.add(CtrlEvent(CtrlEvent::Main, 1, 0));
+  queue.add(CtrlEvent(CtrlEvent::Main, 2, 1));
+  CHECK(queue.coalesced == 1);
+  queue.add(CtrlEvent(CtrlEvent::Switch, 1, 0));
+  queue.add(CtrlEvent(CtrlEvent::X, 1, 0));
+  CHECK(queue.dropped == 2);
+}
+
+TEST_CASE("CtrlRing, push/pop") {
+  CtrlRing ring;
+  CtrlEvent event;
+  CHECK(!ring.pop(event));
+  CHECK(ring.push(CtrlEvent(CtrlEvent::Main, 1, 0)));  // wake consumer
+  CHECK(!ring.push(CtrlEvent(CtrlEvent::X, 1, 0)));  // consumer not caught up
+  CHECK(ring.pop(event));
+  CHECK(event == CtrlEvent(CtrlEvent::Main, 1, 0));
+  CHECK(ring.pop(event));
+  CHECK(event == CtrlEvent(CtrlEvent::X, 1, 0));
+  CHECK(!ring.pop(event));
+  CHECK(ring.push(CtrlEvent(CtrlEvent::Y, 1, 0)));  // caught up again
+}
+
+TEST_CASE("CtrlRing, coalesce") {
+  CtrlRing ring;
+  ring.push(CtrlEvent(CtrlEvent::Main, 1, 0));
+  ring.push(CtrlEvent(CtrlEvent::Main, 2, 1));
+  ring.push(CtrlEvent(CtrlEvent::Main, 4, 2));
+  CtrlEvent event;
+  CHECK(ring.pop(event));
+  CHECK(event == CtrlEvent(CtrlEvent::Main, 4, 0));
+  CHECK(!ring.pop(event));
+  CHECK(ring.get_coalesces() == 2);
+  CHECK(ring.get_drops() == 0);
+}
+
+TEST_CASE("CtrlRing, overflow") {
+  CtrlRing ring;
+  const uint16_t n = 3 * CtrlRing::SIZE;
+  for (uint16_t i = 0; i < n; i++) ring.push(CtrlEvent(CtrlEvent::Main, i + 1, i));
+  CtrlEvent event;
+  CHECK(ring.pop(event));
+  // the ring held SIZE events; the rest are waiting on the producer side
+  CHECK(event == CtrlEvent(CtrlEvent::Main, CtrlRing::SIZE, 0));
+  CHECK(!ring.pop(event));
+  ring.push(CtrlEvent(CtrlEvent::Main, n + 1, n));  // flushes spilled events
+  CHECK(ring.pop(event));
+  CHECK(event == CtrlEvent(CtrlEvent::Main, n + 1, CtrlRing::SIZE));
+  CHECK(ring.get_coalesces() == n - 1);
+  CHECK(ring.get_drops() == 0);
+}
+
+TEST_CASE("CtrlRing, flush") {
+  // spilled events arrive without another push
+  CtrlRing ring;
+  const uint16_t n = 2 * CtrlRing::SIZE;
+  for (uint16_t i = 0; i < n; i++) ring.push(CtrlEvent(CtrlEvent::Main, i + 1, i));
+  CHECK(!ring.flush());  // still full
+  CtrlEvent event;
+  CHECK(ring.pop(event));
+  CHECK(!ring.pop(event));
+  CHECK(ring.flush());  // consumer caught up, so wake it
+  CHECK(!ring.flush());  // nothing left
+  CHECK(ring.pop(event));
+  CHECK(event == CtrlEvent(CtrlEvent::Main, n, CtrlRing::SIZE));
+  CHECK(!ring.pop(event));
+}
+
+TEST_CASE("CtrlRing, switch") {
+  CtrlRing ring;
+  ring.push(CtrlEvent(CtrlEvent::Main, 1, 0));
+  ring.push(CtrlEvent(CtrlEvent::Switch, 1, 0));
+  ring.push(CtrlEvent(CtrlEvent::X, 1, 0));
+  CtrlEvent event;
+  CHECK(ring.pop(event));
+  CHECK(event == CtrlEvent(CtrlEvent::Switch, 1, 0));
+  CHECK(!ring.pop(event));
+  CHECK(ring.get_drops() == 2);
+}
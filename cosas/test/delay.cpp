@@ -0,0 +1,63 @@
+
+#include <vector>
+
+#include "doctest/doctest.h"
+
+#include "cosas/delay.h"
+#include "cosas/random.h"
+
+
+TEST_CASE("PackedDelay, size") {
+  CHECK(sizeof(PackedDelay<16>) <= 3 * sizeof(std::array<int16_t, 1 << 16>) / 4 + 16);
+}
+
+
+TEST_CASE("PackedDelay, samples") {
+  // against a plain int16_t ring, mixing single and block reads and writes
+  PackedDelay<6> d;
+  std::vector<int16_t> all;
+  XorShift32 r(1);
+  for (size_t i = 0; i < 1000; i++) {
+    const size_t n = i % 7;
+    if (n == 0) {
+      all.push_back(r.next_int12());
+      d.write(all.back());
+    } else {
+      std::vector<int16_t> in(n);
+      for (int16_t& s : in) s = r.next_int12();
+      all.insert(all.end(), in.begin(), in.end());
+      d.write(in);
+    }
+    for (size_t delay = 0; delay < std::min(all.size(), d.N); delay++) {
+      CHECK(d.read(delay) == all[all.size() - 1 - delay]);
+    }
+    const size_t m = i % 11 + 1;
+    const size_t delay = i % 13;
+    if (all.size() >= m + delay) {
+      std::vector<int16_t> out(m);
+      d.read(delay, out);
+      for (size_t j = 0; j < m; j++) CHECK(out[j] == all[all.size() - delay - m + j]);
+    }
+  }
+}
+
+
+TEST_CASE("PackedDelay, extremes") {
+  PackedDelay<2> d;
+  for (int16_t s : {SAMPLE_MIN, SAMPLE_MAX, static_cast<int16_t>(-1), static_cast<int16_t>(0)}) d.write(s);
+  CHECK(d.read(3) == SAMPLE_MIN);
+  CHECK(d.read(2) == SAMPLE_MAX);
+  CHECK(d.read(1) == -1);
+  CHECK(d.read(0) == 0);
+}
+
+
+TEST_CASE("PackedDelay, frac") {
+  PackedDelay<4> d;
+  d.write(100);
+  d.write(0);
+  CHECK(d.read_frac(0) == 0);
+  CHECK(d.read_frac(1 << 15) == 50);
+  CHECK(d.read_frac(3 << 14) == 75);
+  CHECK(d.read_frac(1 << 16) == 100);
+}
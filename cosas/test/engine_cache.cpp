@@ -0,0 +1,60 @@
+
+#include "doctest/doctest.h"
+
+#include "cosas/engine_cache.h"
+
+
+TEST_CASE("EngineCache, footprint") {
+  SmallManager m;
+  m.build(SmallManager::OSCILLATOR);
+  size_t osc = m.get_footprint();
+  CHECK(osc > sizeof(PolyTable));
+  m.build(SmallManager::SIMPLE_2_OSC_FM);
+  CHECK(m.get_footprint() > 2 * sizeof(PolyTable));
+  m.build(SmallManager::OSCILLATOR);
+  CHECK(m.get_footprint() == osc);
+}
+
+
+TEST_CASE("EngineCache, reuse") {
+  EngineCache c;
+  RelSource* osc = &c.select(SmallManager::OSCILLATOR);
+  RelSource* fm = &c.select(SmallManager::SIMPLE_2_OSC_FM);
+  CHECK(c.get_builds() == 2);
+  CHECK(c.get_used() <= EngineCache::DEFAULT_BUDGET);
+  CHECK(&c.select(SmallManager::OSCILLATOR) == osc);
+  CHECK(&c.select(SmallManager::SIMPLE_2_OSC_FM) == fm);
+  CHECK(c.get_builds() == 2);
+  CHECK(c.n_built() == 2);
+}
+
+
+TEST_CASE("EngineCache, params retained") {
+  EngineCache c;
+  RelSource& osc = c.select(SmallManager::OSCILLATOR);
+  Param& freq = c.get_manager().get_pane(0).main;
+  freq.set(880);
+  c.select(SmallManager::SIMPLE_2_OSC_FM);
+  CHECK(&c.select(SmallManager::OSCILLATOR) == &osc);
+  CHECK(c.get_manager().get_pane(0).main.get() == doctest::Approx(880));
+}
+
+
+TEST_CASE("EngineCache, eviction") {
+  SmallManager m;
+  m.build(SmallManager::OSCILLATOR);
+  EngineCache c(m.get_footprint() + 1);  // only room for the small engine
+  c.select(SmallManager::OSCILLATOR);
+  c.select(SmallManager::SIMPLE_2_OSC_FM);  // over budget, but active
+  CHECK(c.n_built() == 2);  // previous kept while fading out
+  c.select(SmallManager::SIMPLE_2_OSC_FM);  // previous no longer needed
+  CHECK(c.n_built() == 1);
+  CHECK(c.is_built(SmallManager::SIMPLE_2_OSC_FM));
+  CHECK_FALSE(c.is_built(SmallManager::OSCILLATOR));
+  c.select(SmallManager::OSCILLATOR);
+  c.select(SmallManager::OSCILLATOR);
+  CHECK(c.n_built() == 1);
+  CHECK(c.is_built(SmallManager::OSCILLATOR));
+  CHECK(c.get_used() == m.get_footprint());
+  CHECK(c.get_builds() == 3);
+}
@@ -12,7 +12,7 @@ int16_t ff0(RelSource& src, uint32_t n) {
 
 TEST_CASE("Engine, BuildFM_SIMPLE") {
   OldManager m = OldManager();
-  CHECK(ff0(m.build(m.FM_SIMPLE), 50) == -91);  // arbitrary values
+  CHECK(ff0(m.build(m.FM_SIMPLE), 50) == 13);  // arbitrary values
   CHECK(m.n_panes() == 3);  // carrier, modulator, fm gain/balance
 }
 
@@ -20,7 +20,7 @@ TEST_CASE("Engine, BuildFM_SIMPLE") {
 TEST_CASE("Engine, BuildFM_LFO") {
   OldManager m = OldManager();
   int32_t amp = ff0(m.build(m.FM_LFO), 123);
-  CHECK(amp == 637);  // exact value not important
+  CHECK(amp == 2026);  // exact value not important
   CHECK(m.n_panes() == 4);  // carrier, modulator, lfo, fm gain/balance
 }
 
@@ -28,8 +28,10 @@ TEST_CASE("Engine, BuildFM_LFO") {
 TEST_CASE("Engine, BuildFM_FB") {
   OldManager m = OldManager();
   int32_t amp = ff0(m.build(m.FM_FB), 666);
-  CHECK(amp == 2010);  // exact value not important
-  CHECK(m.n_panes() == 3);  // carrier/filter, modulator, fm gain/balance/flt balance
+  CHECK(amp == -1487);  // exact value not important
+  CHECK(m.n_panes() == 3);  // carrier freq/dex/blk, modulator freq/dex/det, fm gain/wet/fb
+  CHECK(dynamic_cast<Blank*>(&m.get_pane(0).y));
+  CHECK(dynamic_cast<FbDexOsc::FeedbackParam*>(&m.get_pane(2).y));
 }
 
 
@@ -37,3 +39,26 @@ TEST_CASE("Engine, BuildChord") {
   OldManager m = OldManager();
   m.build(m.CHORD);
 }
+
+
+TEST_CASE("Engine, Evaluations") {
+  OldManager m = OldManager();
+  ff0(m.build(m.FM_SIMPLE), 1000);
+  EvalStats s = m.get_eval_stats();
+  CHECK(s.frames == 1000);
+  // two oscillators, but the carrier is also read with modulated phase
+  CHECK(s.evals + s.shared_hits == 3 * s.frames);
+  CHECK(s.repeats + s.shared_hits == s.frames);
+  ff0(m.build(m.CHORD), 1000);
+  s = m.get_eval_stats();
+  CHECK(s.evals == 4 * s.frames);  // no sharing
+  CHECK(s.repeats == 0);
+}
+
+
+TEST_CASE("Engine, Rates") {
+  OldManager m = OldManager();
+  // lfo and envelope paths are control rate, but engine output is audio rate
+  CHECK(m.build(m.FM_LFO).rate_bits() == 0);
+  CHECK(m.build(m.FM_ENV).rate_bits() == 0);
+}
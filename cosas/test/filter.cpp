@@ -45,4 +45,61 @@ TEST_CASE("ThresholdRange") {
   CHECK(tr.add(13, 12));
   CHECK(tr.now == 13);
   CHECK(tr.prev == 10);
-}
\ No newline at end of file
+}
+
+// gain (dB) of a decimator for a sine at hz (relative to the output rate).
+// the output is measured by rms, so includes any alias.
+
+template<typename DECIMATOR> static double decimated_db(size_t rate_bits, double hz) {
+  DECIMATOR d;
+  const size_t n = 1 << rate_bits;
+  constexpr size_t OUT = 4096, SKIP = 64;
+  constexpr double amp = 1500;
+  std::array<uint16_t, 8> block{};
+  double sum = 0, sum2 = 0;
+  for (size_t i = 0; i < OUT + SKIP; i++) {
+    for (size_t j = 0; j < n; j++) {
+      const double t = static_cast<double>(i * n + j) / static_cast<double>(n);
+      block[j] = static_cast<uint16_t>(std::lround(2048 + amp * sin(2 * M_PI * hz * t)));
+    }
+    const double y = d.next(block.data(), 1);
+    if (i >= SKIP) {sum += y; sum2 += y * y;}
+  }
+  const double mean = sum / OUT;
+  const double rms = sqrt(sum2 / OUT - mean * mean);
+  return 20 * log10(rms / (amp / sqrt(2)));
+}
+
+
+TEST_CASE("Decimate, passband") {
+  CHECK(decimated_db<Cic<1, 2>>(2, 0.05) > -0.1);
+  CHECK(decimated_db<Cic<3, 2>>(2, 0.05) > -0.2);
+  CHECK(decimated_db<HalfBand<2>>(2, 0.05) > -0.1);
+  CHECK(decimated_db<HalfBand<2>>(2, 0.2) > -0.5);
+  CHECK(decimated_db<Cic<3, 2>>(2, 0.2) > -2);  // droop
+}
+
+
+TEST_CASE("Decimate, stopband") {
+  // these alias to within 0.2 of the output rate (box average is the old code)
+  for (double hz : {0.8, 0.9, 1.1, 1.2, 1.8, 1.9}) {
+    const double box = decimated_db<Cic<1, 2>>(2, hz);
+    const double cic = decimated_db<Cic<3, 2>>(2, hz);
+    CHECK(box > -23);
+    CHECK(cic < -35);
+    CHECK(cic < box - 20);
+    CHECK(decimated_db<HalfBand<2>>(2, hz) < -44);  // -inf if below 1 bit
+  }
+}
+
+
+TEST_CASE("Decimate, OnePole") {
+  // same response as the smoother it replaced, to rounding
+  OnePole<11, 5, 5> f;
+  uint32_t old = 0;
+  for (uint32_t i = 0; i < 10000; i++) {
+    const uint16_t x = static_cast<uint16_t>((i * 7919) % 4096);
+    old = (21 * old + 11 * (x << 5)) >> 5;
+    CHECK(std::abs(f.next(x) - static_cast<int>(old >> 5)) <= 1);
+  }
+}
@@ -0,0 +1,145 @@
+
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <span>
+#include <vector>
+
+#include "doctest/doctest.h"
+
+#include "cosas/engine_old.h"
+#include "cosas/engine_small.h"
+
+#include "golden.h"
+
+
+// render every engine and compare with the checked in renders in golden/
+// (int16, little endian, GOLDEN_LENGTH samples per engine).  golden.h has
+// a hash of each, which is checked too if the file is missing.
+// to regenerate (after an intentional change in output):
+//   COSAS_GOLDEN=/path/to/cosas/test/golden.h cosas/test/tests -tc="Golden*"
+// which also writes the renders to golden/ next to golden.h.
+
+
+static std::vector<int16_t> render(RelSource& src) {
+  std::vector<int16_t> out(GOLDEN_LENGTH);
+  for (int16_t& s : out) s = src.next(0);
+  return out;
+}
+
+static std::vector<int16_t> render(const Golden& golden) {
+  if (golden.small) {
+    SmallManager m;
+    return render(m.build(static_cast<SmallManager::SmallEngine>(golden.engine)));
+  } else {
+    OldManager m;
+    return render(m.build(static_cast<OldManager::OldEngine>(golden.engine)));
+  }
+}
+
+// fnv-1a
+static uint32_t hash(std::span<const int16_t> samples) {
+  uint32_t h = 2166136261u;
+  for (const int16_t s : samples) {
+    const auto u = static_cast<uint16_t>(s);
+    h = (h ^ (u & 0xff)) * 16777619u;
+    h = (h ^ (u >> 8)) * 16777619u;
+  }
+  return h;
+}
+
+// index of first sample that differs by more than tol (or size if none)
+static size_t first_divergence(std::span<const int16_t> a, std::span<const int16_t> b, int tol) {
+  for (size_t i = 0; i < a.size(); i++) if (std::abs(a[i] - b[i]) > tol) return i;
+  return a.size();
+}
+
+// signal (golden) to noise (difference) ratio in dB
+static float snr(std::span<const int16_t> golden, std::span<const int16_t> actual) {
+  double signal = 0, noise = 0;
+  for (size_t i = 0; i < golden.size(); i++) {
+    signal += golden[i] * static_cast<double>(golden[i]);
+    noise += (actual[i] - golden[i]) * static_cast<double>(actual[i] - golden[i]);
+  }
+  if (noise == 0) return INFINITY;
+  return static_cast<float>(10 * log10(signal / noise));
+}
+
+static std::filesystem::path render_path(const std::filesystem::path& dir, const Golden& golden) {
+  return dir / (std::string(golden.name) + ".raw");
+}
+
+// empty if missing or the wrong length
+static std::vector<int16_t> read_render(const std::filesystem::path& path) {
+  std::ifstream in(path, std::ios::binary);
+  std::vector<uint8_t> bytes(2 * GOLDEN_LENGTH + 1);
+  in.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+  if (static_cast<size_t>(in.gcount()) != 2 * GOLDEN_LENGTH) return {};
+  std::vector<int16_t> samples(GOLDEN_LENGTH);
+  for (size_t i = 0; i < GOLDEN_LENGTH; i++) samples[i] = static_cast<int16_t>(bytes[2 * i] | bytes[2 * i + 1] << 8);
+  return samples;
+}
+
+static void write_render(const std::filesystem::path& path, std::span<const int16_t> samples) {
+  std::vector<uint8_t> bytes;
+  for (const int16_t s : samples) {
+    const auto u = static_cast<uint16_t>(s);
+    bytes.push_back(static_cast<uint8_t>(u));
+    bytes.push_back(static_cast<uint8_t>(u >> 8));
+  }
+  std::ofstream out(path, std::ios::binary);
+  out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+static void write_golden(const char* path) {
+  const std::filesystem::path dir = std::filesystem::path(path).parent_path() / "golden";
+  std::filesystem::create_directories(dir);
+  std::ofstream out(path);
+  out << "\n#ifndef COSAS_TEST_GOLDEN_H\n#define COSAS_TEST_GOLDEN_H\n\n"
+      << "#include <cstddef>\n#include <cstdint>\n\n\n"
+      << "// generated by golden.cpp (see there)\n\n"
+      << "constexpr size_t GOLDEN_LENGTH = " << GOLDEN_LENGTH << ";\n"
+      << "constexpr int GOLDEN_TOLERANCE = " << GOLDEN_TOLERANCE << ";\n\n"
+      << "struct Golden {\n  const char* name;\n  bool small;\n  size_t engine;\n"
+      << "  uint32_t hash;\n};\n\n"
+      << "constexpr Golden GOLDENS[] = {\n";
+  for (const Golden& golden : GOLDENS) {
+    std::vector<int16_t> actual = render(golden);
+    write_render(render_path(dir, golden), actual);
+    out << "  {\"" << golden.name << "\", " << (golden.small ? "true" : "false") << ", " << golden.engine
+        << ", " << hash(actual) << "u},\n";
+  }
+  out << "};\n\n\n#endif\n";
+}
+
+
+TEST_CASE("Golden, engines") {
+  if (const char* path = std::getenv("COSAS_GOLDEN")) {
+    write_golden(path);
+    MESSAGE("wrote " << path);
+    return;
+  }
+  const std::filesystem::path dir = std::filesystem::path(__FILE__).parent_path() / "golden";
+  for (const Golden& golden : GOLDENS) {
+    std::vector<int16_t> actual = render(golden);
+    const std::vector<int16_t> expected = read_render(render_path(dir, golden));
+    if (expected.empty()) {
+      MESSAGE("no render in " << render_path(dir, golden) << ", checking hash only");
+    } else {
+      size_t diverge = first_divergence(expected, actual, GOLDEN_TOLERANCE);
+      if (diverge < GOLDEN_LENGTH) {
+        MESSAGE(golden.name << " diverges at sample " << diverge << ": " << actual[diverge]
+                << " != " << expected[diverge] << ", snr " << snr(expected, actual) << "dB");
+      }
+      CHECK(diverge == GOLDEN_LENGTH);
+    }
+    if (GOLDEN_TOLERANCE == 0 || expected.empty()) {
+      // also catches golden.h and golden/ getting out of step
+      uint32_t h = hash(actual);
+      if (h != golden.hash) MESSAGE(golden.name << " hash differs");
+      CHECK(h == golden.hash);
+    }
+  }
+}
@@ -0,0 +1,36 @@
+
+#ifndef COSAS_TEST_GOLDEN_H
+#define COSAS_TEST_GOLDEN_H
+
+#include <cstddef>
+#include <cstdint>
+
+
+// generated by golden.cpp (see there)
+
+constexpr size_t GOLDEN_LENGTH = 8192;
+constexpr int GOLDEN_TOLERANCE = 0;
+
+struct Golden {
+  const char* name;
+  bool small;
+  size_t engine;
+  uint32_t hash;
+};
+
+constexpr Golden GOLDENS[] = {
+  {"OSCILLATOR", true, 0, 2219306516u},
+  {"SIMPLE_2_OSC_FM", true, 1, 1304440804u},
+  {"FM_4_OP", true, 2, 2033379085u},
+  {"FM_6_OP", true, 3, 2972517545u},
+  {"DEX", false, 0, 1038135614u},
+  {"POLY", false, 1, 483338453u},
+  {"FM_SIMPLE", false, 2, 3504421345u},
+  {"FM_LFO", false, 3, 1239576098u},
+  {"FM_ENV", false, 4, 2285154696u},
+  {"FM_FB", false, 5, 698620937u},
+  {"CHORD", false, 6, 3375661921u},
+};
+
+
+#endif
@@ -0,0 +1,71 @@
+
+#include <cmath>
+
+#include "doctest/doctest.h"
+
+#include "cosas/knobs.h"
+
+
+// the original float response, for comparison
+
+static float response_float(float linearity, uint16_t adc) {
+  const float x = static_cast<float>(adc - 2048) / 4095;
+  return 4.0f * (1.0f - linearity) * powf(x, 3.0f) + linearity * x + 0.5f;
+}
+
+
+class Knob final : public KnobHandler {
+public:
+  Knob(float scale, float linearity) : KnobHandler(scale, linearity, false, 0, 1) {};
+  void reset(float n) {position = static_cast<int32_t>(n * ONE);}
+};
+
+
+TEST_CASE("Knobs, sweep") {
+  // all (now, prev) pairs from the centre, for a few responses
+  for (const float linearity : {0.0f, 0.5f, 1.0f}) {
+    for (const float scale : {0.5f, 1.0f}) {
+      Knob k(scale, linearity);
+      std::array<float, 4096> y{};
+      for (uint16_t i = 0; i < y.size(); i++) y[i] = response_float(linearity, i);
+      float worst = 0;
+      for (uint16_t now = 0; now < 4096; now++) {
+        for (uint16_t prev = 0; prev < 4096; prev++) {
+          k.reset(0.5f);
+          const float expected = std::max(0.0f, std::min(0.999999f, 0.5f + scale * (y[now] - y[prev])));
+          const KnobChange change = k.handle_knob_change(now, prev);
+          worst = std::max(worst, std::abs(change.normalized - expected));
+        }
+      }
+      CHECK(worst < 1e-4f);
+    }
+  }
+}
+
+
+class Captured final : public Param {
+public:
+  Captured(bool log, float lo, float hi) : Param(1, 1, log, lo, hi) {};
+  void set(float v) override {value = v;}
+  float get() override {return value;}
+  float value = 1;
+};
+
+
+TEST_CASE("Knobs, log") {
+  // exponent table against powf over the whole range
+  Captured p(true, -2, 3);
+  ParamAdapter k(p);
+  (void)k.handle_knob_change(0, 4095);  // to bottom
+  float worst = 0;
+  for (uint16_t now = 1; now < 4096; now++) {
+    float expected;
+    {
+      const KnobChange change = k.handle_knob_change(now, now - 1);
+      expected = powf(10, -2 + 5 * change.normalized);
+    }
+    worst = std::max(worst, std::abs(p.value / expected - 1));
+  }
+  CHECK(p.value > 900);
+  CHECK(worst < 1e-4f);
+}
@@ -72,3 +72,29 @@ TEST_CASE("LEDsBuffer, interp3") {
   CHECK(leds_buffer.next() == 0x3b3b3b);
   CHECK(leds_buffer.next() == 0x0f0f0f);
 }
+
+TEST_CASE("LEDsBuffer, force") {
+  auto leds_buffer = LEDsBuffer();
+  leds_buffer.queue(0xf0f0f0, false, false, 0);
+  CHECK(leds_buffer.next() == 0xf0f0f0);
+  leds_buffer.queue(0x0f0f0f, false, true, 0);
+  CHECK(leds_buffer.next() == 0xf0f0f0);
+  CHECK(leds_buffer.next() == 0xb3b3b3);
+  leds_buffer.queue(0x123456, true, false, 1);  // discard rest of interp
+  CHECK(leds_buffer.next() == 0x123456);
+  CHECK(leds_buffer.next() == 0x123456);
+  CHECK(leds_buffer.get_mask() == 0x123456);
+}
+
+TEST_CASE("LEDsBuffer, full") {
+  auto leds_buffer = LEDsBuffer();
+  for (size_t i = 0; i < LEDsBuffer::CAPACITY; i++) CHECK(leds_buffer.queue(i, false, false, 1));
+  CHECK(!leds_buffer.queue(0xffffff, false, false, 0));
+  CHECK(leds_buffer.next() == 0);
+  CHECK(leds_buffer.next() == 1);  // completes first transition
+  CHECK(leds_buffer.queue(0xffffff, false, false, 0));  // space again
+  for (size_t i = 2; i < LEDsBuffer::CAPACITY; i++) {
+    CHECK(leds_buffer.next() == i);
+  }
+  CHECK(leds_buffer.next() == 0xffffff);
+}
@@ -41,3 +41,18 @@ TEST_CASE("LEDsMask, rot2dot") {
   auto leds_mask_5 = LEDsMask(5);
   CHECK(leds_mask_5.rot2dot(1, leds_mask_5.BITS_MASK >> 3, leds_mask_5.BITS_MASK >> 1) == 0x1e378def);
 }
+
+TEST_CASE("LEDsMask, ring") {
+  // exhaustive over the fixed point grid
+  for (uint8_t bits : {4, 5}) {
+    auto leds_mask = LEDsMask(bits);
+    for (uint16_t p = 0; p <= 1 << BaseLEDsMask::RING_BITS; p++) {
+      const float normalized = static_cast<float>(p) / (1 << BaseLEDsMask::RING_BITS);
+      for (bool highlight : {false, true}) {
+        const uint32_t expected = leds_mask.ring_float(normalized, highlight);
+        if (leds_mask.ring_fixed(p, highlight) != expected) CHECK(leds_mask.ring_fixed(p, highlight) == expected);
+        if (leds_mask.ring(normalized, highlight) != expected) CHECK(leds_mask.ring(normalized, highlight) == expected);
+      }
+    }
+  }
+}
@@ -0,0 +1,57 @@
+
+#include <cmath>
+#include <vector>
+
+#include "doctest/doctest.h"
+
+#include "cosas/noise.h"
+
+
+static void stats(NoiseSource& n, double& mean, double& rms, double& r1) {
+  std::vector<int16_t> x(SAMPLE_RATE);
+  for (int16_t& s : x) s = n.next(0);
+  double sum = 0, sum2 = 0, lag = 0;
+  for (size_t i = 0; i < x.size(); i++) {
+    sum += x[i];
+    sum2 += x[i] * static_cast<double>(x[i]);
+    if (i) lag += x[i] * static_cast<double>(x[i - 1]);
+  }
+  mean = sum / static_cast<double>(x.size());
+  rms = sqrt(sum2 / static_cast<double>(x.size()));
+  r1 = lag / sum2;
+}
+
+
+TEST_CASE("NoiseSource, White") {
+  NoiseSource n = NoiseSource(0);
+  double mean, rms, r1;
+  stats(n, mean, rms, r1);
+  CHECK(std::abs(mean) < 20);
+  CHECK(rms == doctest::Approx(SAMPLE_MAX / sqrt(3)).epsilon(0.02));
+  CHECK(std::abs(r1) < 0.02);
+}
+
+
+TEST_CASE("NoiseSource, Smooth") {
+  for (uint8_t s = 1; s <= NoiseSource::MAX_SMOOTH; s++) {
+    NoiseSource n = NoiseSource(s);
+    double mean, rms, r1;
+    (void)n.next(0);
+    for (size_t i = 0; i < (1u << s) * 10; i++) (void)n.next(0);  // settle
+    stats(n, mean, rms, r1);
+    CHECK(rms == doctest::Approx(SAMPLE_MAX / 3.0).epsilon(s < 6 ? 0.05 : 0.2));
+    CHECK(r1 == doctest::Approx(1 - 1.0 / (1 << s)).epsilon(0.02));  // one pole
+    CHECK(n.get_smooth_param().get() == s);
+  }
+}
+
+
+TEST_CASE("NoiseSource, NoLoop") {
+  // the Noise wavetable repeats every second
+  NoiseSource n = NoiseSource(0);
+  std::vector<int16_t> x(2 * SAMPLE_RATE);
+  for (int16_t& s : x) s = n.next(0);
+  size_t same = 0;
+  for (size_t i = 0; i < SAMPLE_RATE; i++) if (x[i] == x[i + SAMPLE_RATE]) same++;
+  CHECK(same < SAMPLE_RATE / 100);
+}
@@ -0,0 +1,110 @@
+
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+#include "doctest/doctest.h"
+
+#include "cosas/oscillator_new.h"
+#include "cosas/wavetable.h"
+
+
+TEST_CASE("Oscillator, FbDexOscNoFeedback") {
+  Wavelib w = Wavelib();
+  AbsDexOsc root = AbsDexOsc(440, w, w.sine_gamma_1);
+  RelDexOsc o1 = RelDexOsc(w, w.sine_gamma_1, root.get_freq_param(), 2, 1);
+  FbDexOsc o2 = FbDexOsc(w, w.sine_gamma_1, root.get_freq_param(), 2, 1, 0);
+  for (size_t i = 0; i < 1000; i++) CHECK(o1.next(0) == o2.next(0));
+}
+
+
+TEST_CASE("Oscillator, FbDexOscFeedback") {
+  Wavelib w = Wavelib();
+  AbsDexOsc root = AbsDexOsc(440, w, w.sine_gamma_1);
+  RelDexOsc o1 = RelDexOsc(w, w.sine_gamma_1, root.get_freq_param(), 1, 1);
+  FbDexOsc o2 = FbDexOsc(w, w.sine_gamma_1, root.get_freq_param(), 1, 1, 1);
+  size_t differ = 0;
+  for (size_t i = 0; i < 1000; i++) {
+    int16_t a = o1.next(0), b = o2.next(0);
+    if (a != b) differ++;
+    CHECK(b >= SAMPLE_MIN);
+    CHECK(b <= SAMPLE_MAX);
+  }
+  CHECK(differ > 900);
+  CHECK(o2.get_fb_param().get() == doctest::Approx(1));
+}
+
+
+// energy (as a fraction of the total) that is not at a harmonic of hz.
+// the render is exactly one second so harmonics fall on integer bins.
+static double aliased(const std::vector<int16_t>& x, uint32_t hz) {
+  double total = 0;
+  for (const int16_t s : x) total += s * static_cast<double>(s);
+  double harmonic = 0;
+  for (uint32_t k = 0; k * hz < SAMPLE_RATE / 2; k++) {
+    // goertzel
+    const double w = 2 * std::numbers::pi * k * hz / SAMPLE_RATE;
+    const double c = 2 * cos(w);
+    double s1 = 0, s2 = 0;
+    for (const int16_t s : x) {
+      const double s0 = s + c * s1 - s2;
+      s2 = s1;
+      s1 = s0;
+    }
+    const double power = (s1 * s1 + s2 * s2 - c * s1 * s2) / static_cast<double>(x.size());
+    harmonic += k ? 2 * power : power;
+  }
+  return (total - harmonic) / total;
+}
+
+static std::vector<int16_t> render(RelSource& src) {
+  std::vector<int16_t> x(SAMPLE_RATE);
+  for (int16_t& s : x) s = src.next(0);
+  return x;
+}
+
+static std::vector<int16_t> render(const Wavetable& t, uint32_t hz) {
+  std::vector<int16_t> x(SAMPLE_RATE);
+  int32_t tick = 0;
+  for (int16_t& s : x) {
+    tick = (tick + static_cast<int32_t>(hz2freq(static_cast<float>(hz)))) % static_cast<int32_t>(FULL_TABLE_SUB);
+    s = t.next(tick);
+  }
+  return x;
+}
+
+
+TEST_CASE("Oscillator, BlepAliasing") {
+  for (const uint32_t hz : {1000u, 2000u, 5000u}) {
+    BlepSquare bsq = BlepSquare(static_cast<float>(hz), 0.5f);
+    BlepSaw bsaw = BlepSaw(static_cast<float>(hz), 1);
+    BlepSaw btri = BlepSaw(static_cast<float>(hz), 0.5f);
+    const double sq = aliased(render(Square(0.5f), hz), hz), sq_bl = aliased(render(bsq), hz);
+    const double saw = aliased(render(WSaw(1), hz), hz), saw_bl = aliased(render(bsaw), hz);
+    const double tri = aliased(render(Saw(0.5f), hz), hz), tri_bl = aliased(render(btri), hz);
+    MESSAGE(hz << "Hz aliased energy (dB) square " << 10 * log10(sq) << " -> " << 10 * log10(sq_bl)
+            << ", saw " << 10 * log10(saw) << " -> " << 10 * log10(saw_bl)
+            << ", tri " << 10 * log10(tri) << " -> " << 10 * log10(tri_bl));
+    CHECK(sq_bl < sq / 10);
+    CHECK(saw_bl < saw / 10);
+    CHECK(tri_bl < tri / 10);
+  }
+}
+
+
+TEST_CASE("Oscillator, BlepShape") {
+  // away from the discontinuities these match the naive waveforms
+  BlepSquare sq = BlepSquare(100, 0.3f);
+  BlepSaw tri = BlepSaw(100, 0);
+  const std::vector<int16_t> a = render(sq), b = render(Square(0.3f), 100);
+  const std::vector<int16_t> c = render(tri), d = render(Saw(0), 100);
+  size_t sq_same = 0, tri_close = 0;
+  for (size_t i = 0; i < SAMPLE_RATE; i++) {
+    if (a[i] == b[i]) sq_same++;
+    if (std::abs(c[i] - d[i]) < 10) tri_close++;
+  }
+  CHECK(sq_same > SAMPLE_RATE * 98 / 100);
+  CHECK(tri_close > SAMPLE_RATE * 98 / 100);
+  CHECK(sq.get_duty_param().get() == doctest::Approx(0.3).epsilon(0.001));
+  CHECK(tri.get_offset_param().get() == doctest::Approx(0).epsilon(0.001));
+}
@@ -1,7 +1,14 @@
 
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
 #include "doctest/doctest.h"
 
+#include "cosas/constants.h"
+
 #include "cosas/random.h"
 
 
@@ -31,3 +38,65 @@ TEST_CASE("XorShift32, bool") {
   CHECK(!rand.next_bool());
   CHECK(rand.next_bool());
 }
+
+TEST_CASE("XorShift32, fill") {
+  XorShift32 rand = XorShift32(1);
+  std::vector<int16_t> x(1 << 20);
+  rand.fill(x);
+  // range, mean and a chi-squared test over 64 bins (63 dof, so the 99.9%
+  // point is about 104)
+  std::array<double, 64> counts{};
+  double sum = 0;
+  size_t out_of_range = 0;
+  for (const int16_t v : x) {
+    if (v < SAMPLE_MIN || v > SAMPLE_MAX) {out_of_range++; continue;}
+    sum += v;
+    counts[static_cast<size_t>((v - SAMPLE_MIN) >> 6)]++;
+  }
+  CHECK(out_of_range == 0);
+  CHECK(std::abs(sum / static_cast<double>(x.size())) < 5);
+  double chi2 = 0;
+  constexpr double values = 2 * SAMPLE_MAX + 1;
+  for (size_t i = 0; i < counts.size(); i++) {
+    const double width = i + 1 < counts.size() ? 64 : values - 64 * 63;
+    const double expected = static_cast<double>(x.size()) * width / values;
+    chi2 += (counts[i] - expected) * (counts[i] - expected) / expected;
+  }
+  CHECK(chi2 < 104);
+  // no correlation between neighbours, lanes or halves of a lane
+  for (const size_t lag : {1ul, XorShift32::LANES, 2 * XorShift32::LANES}) {
+    double c = 0, v = 0;
+    for (size_t i = lag; i < x.size(); i++) {
+      c += x[i] * static_cast<double>(x[i - lag]);
+      v += x[i] * static_cast<double>(x[i]);
+    }
+    CHECK(std::abs(c / v) < 0.01);
+  }
+}
+
+TEST_CASE("XorShift32, fill tail") {
+  // blocks split at any size give the same values
+  XorShift32 a = XorShift32(1), b = XorShift32(1);
+  std::array<int16_t, 16> x{}, y{};
+  a.fill(x);
+  b.fill(std::span(y).first(8));
+  b.fill(std::span(y).subspan(8));
+  CHECK(x == y);
+  // including splits that are not on a block boundary
+  for (size_t split : {1, 5, 7, 9, 13}) {
+    XorShift32 d = XorShift32(1);
+    std::array<int16_t, 16> w{};
+    d.fill(std::span(w).first(split));
+    d.fill(std::span(w).subspan(split));
+    CHECK(x == w);
+  }
+  XorShift32 e = XorShift32(1);
+  std::array<int16_t, 16> v{};
+  for (size_t i = 0; i < v.size(); i += 3) e.fill(std::span(v).subspan(i, std::min<size_t>(3, v.size() - i)));
+  CHECK(x == v);
+  std::array<int16_t, 3> z{};
+  XorShift32 c = XorShift32(1);
+  c.fill(z);
+  CHECK(z[0] == x[0]);
+  CHECK(z[2] == x[2]);
+}
@@ -0,0 +1,118 @@
+
+#include <algorithm>
+#include <vector>
+
+#include "doctest/doctest.h"
+
+#include "cosas/xqria.h"
+
+using namespace xqria;
+
+
+TEST_CASE("Xqria, LFSR16") {
+  // maximal length
+  LFSR16 lfsr;
+  const uint start = lfsr.get_state();
+  uint period = 1;
+  while (lfsr.get_state() != start) period++;
+  CHECK(period == 0xffff);
+}
+
+
+TEST_CASE("Xqria, Tables") {
+  const Rate rate(0);
+  const float a = static_cast<float>(freq_table()[A_IDX] * rate.sample_rate_hz) / static_cast<float>(rate.tau_n);
+  CHECK(a == doctest::Approx(440).epsilon(0.001));
+  for (uint i = 1; i < FREQ_N; i++) CHECK(freq_table()[i] > freq_table()[i - 1]);
+  CHECK(amp_table()[0] == 1);
+  CHECK(amp_table()[AMP_N - 1] == INTERNAL_MAX);
+  for (uint i = 1; i < AMP_N; i++) CHECK(amp_table()[i] >= amp_table()[i - 1]);
+}
+
+
+template<uint OS> static void check_quarter() {
+  constexpr Rate rate(OS);
+  constexpr uint quarter = rate.tau_n >> 2;
+  const Quarter<SINE, rate.tau_bits> sine;
+  const Quarter<TM50S, rate.tau_bits> tm50s;
+  const Quarter<TRIANGLE, rate.tau_bits> triangle;
+  const Quarter<SQUARE, rate.tau_bits> square;
+  CHECK(sine(INTERNAL_MAX, 0) == 0);
+  CHECK(sine(INTERNAL_MAX, quarter) > static_cast<int>(INTERNAL_MAX) - 4);
+  CHECK(triangle(INTERNAL_MAX, quarter) > static_cast<int>(INTERNAL_MAX) - 4);
+  CHECK(triangle(INTERNAL_MAX, quarter / 2) == doctest::Approx(INTERNAL_MAX / 2).epsilon(0.001));
+  CHECK(square(INTERNAL_MAX, 1) == -square(INTERNAL_MAX, rate.tau_max));
+  for (uint phase = 0; phase < 2 * quarter; phase += 97) {
+    CHECK(sine(0x8000, phase) == -sine(0x8000, phase + 2 * quarter));
+    CHECK(tm50s(0x8000, phase) == tm50s(0x8000, 2 * quarter - phase));
+  }
+  // same shape at any oversampling
+  const Quarter<SINE, Rate(0).tau_bits> sine0;
+  for (uint phase = 0; phase < rate.tau_n; phase += 13 << OS) CHECK(sine(0x8000, phase) == sine0(0x8000, phase >> OS));
+}
+
+TEST_CASE("Xqria, Quarter") {
+  // full cycle from the quarter table, for each oversampling
+  for (uint os = 0; os <= MAX_OVERSAMPLE_BITS; os++) {
+    CHECK(oversampled(os, [](auto o) {return decltype(o)::value;}) == os);
+    oversampled(os, [](auto o) {check_quarter<decltype(o)::value>();});
+  }
+}
+
+
+TEST_CASE("Xqria, Voice") {
+  // each drum sounds and then stops, taking twice as long with more oversampling
+  for (uint amp : {0x7fffu, 0xff00u}) {
+    for (uint freq : {160u << 4, INTERNAL_MSB | (160 << 4)}) {
+      uint prev = 0;
+      for (uint os = 1; os < 3; os++) {
+        const Rate rate(os);
+        Voice v(0, amp, freq, 0x4000, 0x8000, 0);
+        CHECK(!v.active());
+        CHECK(v.output(rate) == 0);
+        v.trigger();
+        uint n = 0, loud = 0;
+        while (v.active()) {
+          loud += v.output(rate) != 0;
+          n++;
+        }
+        CHECK(loud > n / 2);
+        if (prev) CHECK(n == 2 * prev - 1);
+        prev = n;
+      }
+    }
+  }
+}
+
+
+TEST_CASE("Xqria, Euclidean") {
+  // without jiggle every beat is triggered once per cycle
+  for (uint n_beats = 1; n_beats <= 16; n_beats++) {
+    Euclidean e(16, n_beats, 0.5f, 0, 2);
+    uint main = 0, minor = 0;
+    for (uint place = 0; place < 16; place++) {
+      const int a = e.on_beat(true), b = e.on_beat(false);
+      CHECK((a == -1 || a == 2));
+      CHECK((b == -1 || b == 3));
+      main += a == 2;
+      minor += b == 3;
+    }
+    CHECK(main + minor == n_beats);
+    CHECK(main == static_cast<uint>(std::round(static_cast<float>(n_beats) * 0.5f)));
+  }
+}
+
+
+TEST_CASE("Xqria, Audio") {
+  // deterministic, and silent (mid-scale) when no voices are enabled
+  Audio a, b, c;
+  c.enabled = 0;
+  std::vector<uint8_t> sa(2 * BASE_RATE_HZ), sb(2 * BASE_RATE_HZ), sc(2 * BASE_RATE_HZ);
+  a.generate(sa);
+  b.generate({sb.data(), 1000});
+  b.generate({sb.data() + 1000, sb.size() - 1000});
+  c.generate(sc);
+  CHECK(sa == sb);
+  CHECK(std::ranges::count(sc, 0x80) == static_cast<long>(sc.size()));
+  CHECK(std::ranges::count(sa, 0x80) < static_cast<long>(sa.size() / 2));
+}
@@ -16,6 +16,7 @@
 #include "cosas/common.h"
 #include "cosas/constants.h"
 #include "cosas/ctrl.h"
+#include "cosas/filter.h"
 
 #include "weas/weas.h"
 
@@ -26,6 +27,8 @@
 // * selectable ADC correction (DNL issues), scaling, and masks
 // * modified filtering of CV (1/10 nyquist) and ctrls (1/100 nyquist)
 // * callback for ctrl events with reduced sample rate (see fifo.h)
+// * optional DMA for CV out (see select_cv_dma())
+// * selectable decimation of oversampled audio (see select_decimator())
 
 // separated into two classes:
 // * Codec is the interface used elsewhere, but cannot be instantiated directly
@@ -52,6 +55,8 @@ public:
     All = 15
   };
   enum ADCSource { Audios, CVs, Knobs };
+  // how oversampled audio is reduced (see filter.h).  Box is a plain average.
+  enum Decimator { Box, CIC, HalfBands };
   static constexpr uint N_ADC_SOURCES = Knobs + 1;
 
   Codec(const Codec&) = delete;
@@ -75,6 +80,13 @@ public:
   // use a bigger number if you lower SAMPLE_FREQ and knobs become sluggish
   void set_ctrl_alpha(uint a) { ctrl_alpha = std::min(6u, std::max(1u, a)); }
   void set_ctrl_sample_rate(uint bits) { ctrl_sample_mask = ((1u << bits) - 1) << 2; }
+  // by default cv out is error diffused into the pwm level on every pwm wrap
+  // interrupt.  with dma the diffused sequence for the current value is
+  // precomputed (only when it changes) and streamed into the pwm slice,
+  // removing the interrupt.  changes may take a block (~4ms) to appear, so
+  // this suits slowly changing cv (pitch, sequences).  call before start().
+  void select_cv_dma(bool on) { use_cv_dma = on; }
+  void select_decimator(Decimator d) { decimator = d; }
 
   [[nodiscard]] uint16_t __not_in_flash_func(read_ctrl)(CtrlEvent::Ctrl k) { return ctrls[Now][k]; }
   [[nodiscard]] uint16_t __not_in_flash_func(read_ctrl)(uint k) { return read_ctrl(static_cast<CtrlEvent::Ctrl>(k)); }
@@ -137,6 +149,7 @@ protected:
   static constexpr uint DAC_TX = 19;
   static constexpr uint EEPROM_SDA = 16;
   static constexpr uint EEPROM_SCL = 17;
+  static constexpr uint EEPROM_HZ = 400 * 1000;  // fast mode (24C-series parts), speed-up not measured
   static constexpr uint PULSE_IN = 2;  // and 3
 
   static constexpr uint SPI_DREQ = DREQ_SPI0_TX;
@@ -151,6 +164,8 @@ protected:
 
   CtrlHandler* ctrl_changes = nullptr;
   bool track_ctrl_changes = false;
+  bool use_cv_dma = false;
+  Decimator decimator = Box;
   uint ctrl_alpha = 2;  // see discussions below
   uint32_t ctrl_sample_mask = 0xf << 2;
 
@@ -164,7 +179,7 @@ protected:
   uint32_t starting = 10;
   volatile ADCRunMode run_mode;
 
-  uint32_t cv_out[N_CHANNELS] = {262144u, 262144u};  // TODO - again, hardcoding length  TODO - unsure of type here, audio was wrong
+  volatile uint32_t cv_out[N_CHANNELS] = {262144u, 262144u};  // TODO - again, hardcoding length  TODO - unsure of type here, audio was wrong
   int16_t audio_out[N_CHANNELS] = {};
   volatile int16_t ctrls[N_WHEN][CtrlEvent::N_CTRLS] = {};
   volatile bool pulse[N_CHANNELS] = {};
@@ -216,13 +231,26 @@ private:
 
   void handle_adc();
   void handle_cv();
+  void fill_cv_block(uint32_t* block);
+  void update_cv_block();
   uint32_t probe_out = 0;
   static constexpr uint EXTRA = 5;  // extra "fractional" bits for filter
   uint16_t adc_buffer[N_PHASES][4 * OVERSAMPLES] = {};
   volatile uint32_t smooth_ctrls[CtrlEvent::N_CTRLS] = {};
-  volatile uint32_t smooth_cv[N_CHANNELS] = {};
+  OnePole<11, 5, EXTRA> smooth_cv[N_CHANNELS] = {};  // alpha 11/32 (see handle_adc)
+  Cic<3, OVERSAMPLE_BITS> cic[N_CHANNELS] = {};
+  HalfBand<OVERSAMPLE_BITS> half_band[N_CHANNELS] = {};
   int32_t cv_error[N_CHANNELS] = {};
 
+  // a constant value (8 fractional bits) repeats after 256 steps of error
+  // diffusion, so each block loops exactly.  blocks are 1k aligned for dma.
+  static constexpr uint CV_BLOCK_BITS = 8;
+  static constexpr uint CV_BLOCK_N = 1 << CV_BLOCK_BITS;
+  alignas(CV_BLOCK_N * sizeof(uint32_t)) uint32_t cv_block[N_PHASES][CV_BLOCK_N] = {};
+  uint32_t* volatile cv_block_next = cv_block[0];  // read by the control channel
+  uint32_t cv_block_value[N_CHANNELS] = {};  // values in cv_block_next
+  uint8_t cv_dma = 0, cv_ctrl_dma = 0;
+
   static void adc_callback() {
     CodecFactory& cf = CodecFactory::get();
     cf.handle_adc();
@@ -274,7 +302,7 @@ template <uint O, uint S> CodecFactory<O, S>::CodecFactory() {
   gpio_set_function(DAC_TX, GPIO_FUNC_SPI);
   gpio_set_function(DAC_CS, GPIO_FUNC_SPI);
 
-  i2c_init(i2c0, 100 * 1000);
+  i2c_init(i2c0, EEPROM_HZ);
   gpio_set_function(EEPROM_SDA, GPIO_FUNC_I2C);
   gpio_set_function(EEPROM_SCL, GPIO_FUNC_I2C);
 
@@ -319,11 +347,33 @@ CodecFactory<O, SAMPLE_FREQ>::start() {
   irq_set_exclusive_handler(DMA_IRQ_0, adc_callback);
 
   uint slice_num = pwm_gpio_to_slice_num(CV_OUT);
-  pwm_clear_irq(slice_num);
-  pwm_set_irq_enabled(slice_num, true);
-  irq_set_exclusive_handler(PWM_IRQ_WRAP, cv_callback);
-  irq_set_priority(PWM_IRQ_WRAP, 255);
-  irq_set_enabled(PWM_IRQ_WRAP, true);
+  if (use_cv_dma) {
+    // data channel writes one block into both levels (one per wrap), then
+    // chains to the control channel, which restarts it from cv_block_next.
+    fill_cv_block(cv_block[0]);
+    cv_block_next = cv_block[0];
+    cv_dma = dma_claim_unused_channel(true);
+    cv_ctrl_dma = dma_claim_unused_channel(true);
+    dma_channel_config cv_dmacfg = dma_channel_get_default_config(cv_dma);
+    channel_config_set_transfer_data_size(&cv_dmacfg, DMA_SIZE_32);
+    channel_config_set_read_increment(&cv_dmacfg, true);
+    channel_config_set_write_increment(&cv_dmacfg, false);
+    channel_config_set_dreq(&cv_dmacfg, DREQ_PWM_WRAP0 + slice_num);
+    channel_config_set_chain_to(&cv_dmacfg, cv_ctrl_dma);
+    dma_channel_configure(cv_dma, &cv_dmacfg, &pwm_hw->slice[slice_num].cc, cv_block[0], CV_BLOCK_N, false);
+    dma_channel_config ctrl_dmacfg = dma_channel_get_default_config(cv_ctrl_dma);
+    channel_config_set_transfer_data_size(&ctrl_dmacfg, DMA_SIZE_32);
+    channel_config_set_read_increment(&ctrl_dmacfg, false);
+    channel_config_set_write_increment(&ctrl_dmacfg, false);
+    dma_channel_configure(cv_ctrl_dma, &ctrl_dmacfg, &dma_hw->ch[cv_dma].al3_read_addr_trig, &cv_block_next, 1, false);
+    dma_channel_start(cv_dma);
+  } else {
+    pwm_clear_irq(slice_num);
+    pwm_set_irq_enabled(slice_num, true);
+    irq_set_exclusive_handler(PWM_IRQ_WRAP, cv_callback);
+    irq_set_priority(PWM_IRQ_WRAP, 255);
+    irq_set_enabled(PWM_IRQ_WRAP, true);
+  }
 
   spi_dmacfg = dma_channel_get_default_config(spi_dma);
   channel_config_set_transfer_data_size(&spi_dmacfg, DMA_SIZE_16);
@@ -333,6 +383,7 @@ CodecFactory<O, SAMPLE_FREQ>::start() {
   adc_run(true);
 
   while (true) {
+    if (use_cv_dma) update_cv_block();
     if (run_mode == ReqStart) {
       run_mode = Started;
 
@@ -345,9 +396,18 @@ CodecFactory<O, SAMPLE_FREQ>::start() {
       adc_set_round_robin(0b0001111U);
       adc_run(true);
     } else if (run_mode == Stopped) {
-      irq_set_enabled(PWM_IRQ_WRAP, false);
-      pwm_clear_irq(pwm_gpio_to_slice_num(CV_OUT));
-      irq_remove_handler(PWM_IRQ_WRAP, cv_callback);
+      if (use_cv_dma) {
+        // data may chain to control during the abort, so abort control twice
+        dma_channel_abort(cv_ctrl_dma);
+        dma_channel_abort(cv_dma);
+        dma_channel_abort(cv_ctrl_dma);
+        dma_channel_unclaim(cv_dma);
+        dma_channel_unclaim(cv_ctrl_dma);
+      } else {
+        irq_set_enabled(PWM_IRQ_WRAP, false);
+        pwm_clear_irq(pwm_gpio_to_slice_num(CV_OUT));
+        irq_remove_handler(PWM_IRQ_WRAP, cv_callback);
+      }
       break;
     }
   }
@@ -388,8 +448,7 @@ void CodecFactory<OVERSAMPLE_BITS, F>::handle_adc() {
   // so alpha/2pi = 1/10, but then alpha is no longer small, and using the other formula we get alpha = 1/3
   // and keep an extra 4 bits for noise:
 
-  smooth_cv[cv_lr] = (21 * smooth_cv[cv_lr] + 11 * (adc_buffer[cpu_phase][3] << EXTRA)) >> 5;
-  uint16_t cv_tmp = smooth_cv[cv_lr] >> EXTRA;
+  uint16_t cv_tmp = smooth_cv[cv_lr].next(adc_buffer[cpu_phase][3]);
   if (adc_correct_mask & (C1 << cv_lr)) {
     cv_tmp = adc_correction(cv_tmp);
     if (scale_adc) cv_tmp = apply_adc_scale(cv_tmp);
@@ -397,9 +456,22 @@ void CodecFactory<OVERSAMPLE_BITS, F>::handle_adc() {
   cv_in[cv_lr] = static_cast<int16_t>(0x800 - (cv_tmp & adc_mask[CVs]));
 
   for (uint audio_lr = 0; audio_lr < N_CHANNELS; audio_lr++) {
-    uint32_t audio_tmp_wide = 0;
-    for (uint i = 0; i < OVERSAMPLES; ++i) audio_tmp_wide += adc_buffer[cpu_phase][audio_lr + 4 * i];
-    auto audio_tmp = static_cast<uint16_t>(audio_tmp_wide >> OVERSAMPLE_BITS);
+    const uint16_t* oversampled = adc_buffer[cpu_phase] + audio_lr;
+    uint16_t audio_tmp;
+    switch (decimator) {
+    case CIC:
+      audio_tmp = cic[audio_lr].next(oversampled, 4);
+      break;
+    case HalfBands:
+      audio_tmp = half_band[audio_lr].next(oversampled, 4);
+      break;
+    default: {
+      uint32_t audio_tmp_wide = 0;
+      for (uint i = 0; i < OVERSAMPLES; ++i) audio_tmp_wide += oversampled[4 * i];
+      audio_tmp = static_cast<uint16_t>(audio_tmp_wide >> OVERSAMPLE_BITS);
+      break;
+    }
+    }
     if (adc_correct_mask & (A1 << audio_lr)) {
       audio_tmp = adc_correction(audio_tmp);
       if (scale_adc) audio_tmp = apply_adc_scale(audio_tmp);
@@ -466,8 +538,9 @@ void CodecFactory<OVERSAMPLE_BITS, F>::handle_adc() {
   }
 
   if (!starting) {
-    if (sample_ctrls && track_ctrl_changes && ctrl_changed(ctrl) && ctrl_changes) {
-      ctrl_changes->handle_ctrl_change(CtrlEvent(ctrl, ctrls[Now][ctrl], ctrls[Prev][ctrl]));
+    if (sample_ctrls && track_ctrl_changes && ctrl_changes) {
+      if (ctrl_changed(ctrl)) ctrl_changes->handle_ctrl_change(CtrlEvent(ctrl, ctrls[Now][ctrl], ctrls[Prev][ctrl]));
+      else ctrl_changes->handle_ctrl_tick();
     }
     if (use_norm_probe && track_connected_changes && connected_changes) {
       for (uint skt = 0; skt < N_SOCKET_IN; skt++) {
@@ -501,12 +574,44 @@ void CodecFactory<OVERSAMPLE_BITS, F>::handle_cv() {
   // TODO - understand this (looks like lowest 8 bits are accumulated until significant?)
   pwm_clear_irq(pwm_gpio_to_slice_num(CV_OUT)); // clear the interrupt flag
   for (uint lr = 0; lr < N_CHANNELS; lr++) {
-    uint32_t truncated = (cv_out[lr] - cv_error[lr]) & 0xffffff00;
-    cv_error[lr] += truncated - cv_out[lr];
+    const uint32_t v = cv_out[lr];  // read once (volatile)
+    uint32_t truncated = (v - cv_error[lr]) & 0xffffff00;
+    cv_error[lr] += truncated - v;
     // CV pins swapped
     pwm_set_gpio_level(CV_OUT + (1 - lr), truncated >> 8);
   }
 }
 
 
+template <uint OVERSAMPLE_BITS, uint F>
+void CodecFactory<OVERSAMPLE_BITS, F>::fill_cv_block(uint32_t* block) {
+  // as handle_cv(), but for a whole block.  channel a (CV_OUT) is the low
+  // half of the cc register and b the high half (CV pins swapped).
+  for (uint lr = 0; lr < N_CHANNELS; lr++) cv_block_value[lr] = cv_out[lr];
+  int32_t error[N_CHANNELS] = {};
+  for (uint i = 0; i < CV_BLOCK_N; i++) {
+    uint32_t cc = 0;
+    for (uint lr = 0; lr < N_CHANNELS; lr++) {
+      uint32_t truncated = (cv_block_value[lr] - error[lr]) & 0xffffff00;
+      error[lr] += truncated - cv_block_value[lr];
+      cc |= (truncated >> 8) << (lr == Left ? 16 : 0);
+    }
+    block[i] = cc;
+  }
+}
+
+template <uint OVERSAMPLE_BITS, uint F>
+void CodecFactory<OVERSAMPLE_BITS, F>::update_cv_block() {
+  // called from the (otherwise idle) loop in start(), not the audio interrupt
+  if (cv_out[Left] == cv_block_value[Left] && cv_out[Right] == cv_block_value[Right]) return;
+  // wait until any previous change is playing, so at most one fill per block
+  uintptr_t read = dma_channel_hw_addr(cv_dma)->read_addr;
+  if (read == reinterpret_cast<uintptr_t>(cv_block[1])) return;  // end of 0 or start of 1
+  uint playing = read >= reinterpret_cast<uintptr_t>(cv_block[1]) ? 1 : 0;
+  if (cv_block_next != cv_block[playing]) return;
+  fill_cv_block(cv_block[1 - playing]);
+  cv_block_next = cv_block[1 - playing];
+}
+
+
 #endif
@@ -3,6 +3,7 @@
 #define WEAS_EEPROM_H
 
 
+#include "hardware/flash.h"
 #include "hardware/gpio.h"
 
 #include "weas.h"
@@ -13,6 +14,22 @@
 // midi output is here because it needs calibration data
 // (presumably to generate the correct notes!)
 
+// calibration is read from the eeprom in a single (sequential) transfer
+// and a copy is kept in the last sector of flash.  on later boots only the
+// id and crc are read from the eeprom; if they match the copy the rest is
+// not read.  the copy is written (via flash_safe_execute) from the
+// constructor.  before core1 is launched that is safe because weas is built
+// with PICO_FLASH_ASSUME_CORE1_SAFE; once it is running core1 is locked out
+// (FIFO::core1_marshaller registers it with flash_safe_execute_core_init()).
+// if the write is refused or times out get_flash_copy_valid() is false and
+// the eeprom is read again on the next boot.  timings (bus speed, cache)
+// are estimates, not yet measured.
+
+// calibration is applied once, at startup, to give a note -> dac table
+// per channel (in ram).  fractional notes (NOTE_FRAC_BITS fixed point, so
+// glide and vibrato) interpolate the table, at the same cost for every
+// sample.
+
 
 class EEPROM {
 
@@ -33,11 +50,19 @@ public:
   HardwareVersion get_hardware_version() const { return hw; }
   uint64_t get_unique_id() const { return unique_id; }
   uint16_t crc_encode(const uint8_t *data, uint length);
+  uint64_t get_read_us() const { return read_us; }  // time taken to read calibration
+  bool get_read_from_flash() const { return read_from_flash; }  // this boot used the flash copy
+  bool get_flash_copy_valid() const { return flash_copy_valid; }  // flash copy matches eeprom (read or written)
+
+  static constexpr uint N_NOTES = 128;
+  static constexpr uint8_t NOTE_FRAC_BITS = 8;  // 1/256 semitone is ~0.4 cents
 
   uint32_t midi_to_dac(Channel lr, uint midiNote);
   uint32_t midi_to_dac(uint lr, uint midiNote);
+  uint32_t frac_note_to_dac(Channel lr, uint32_t note);
   void write_cv_midi_note(Codec &cc, Channel lr, uint8_t note_num);
   void write_cv_midi_note(Codec &cc, uint lr, uint8_t note_num);
+  void write_cv_frac_note(Codec &cc, Channel lr, uint32_t note);
 
 private:
   static constexpr uint USB_HOST_STATUS = 20;
@@ -51,6 +76,16 @@ private:
   static constexpr uint EEPROM_VAL_ID = 2001;
   static constexpr uint EEPROM_NUM_BYTES = 88;
   static constexpr uint EEPROM_PAGE_ADDRESS = 0x50;
+  static constexpr uint32_t CACHE_MAGIC = 0x63616c31;  // "cal1"
+  static constexpr uint32_t CACHE_TIMEOUT_MS = 100;
+  static constexpr uint32_t CACHE_OFFSET = PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE;
+
+  // padded to a flash page
+  typedef struct {
+    uint32_t magic;
+    uint8_t data[EEPROM_NUM_BYTES];
+    uint8_t padding[FLASH_PAGE_SIZE - sizeof(uint32_t) - EEPROM_NUM_BYTES];
+  } Cache;
 
   EEPROM();
 
@@ -69,12 +104,21 @@ private:
   uint8_t num_calibration_points[N_CHANNELS] = {};
   CalPoint calibration_table[N_CHANNELS][CAL_MAX_POINTS] = {};
   CalCoeffs cal_coeffs[N_CHANNELS] = {};
+  uint32_t note_table[N_CHANNELS][N_NOTES + 1] = {};  // extra entry for interpolation
   uint64_t unique_id;
   HardwareVersion hw;
+  uint64_t read_us = 0;
+  bool read_from_flash = false;
+  bool flash_copy_valid = false;
 
-  uint8_t read_byte_from_eeprom(uint ee_addr);
+  void read_bytes_from_eeprom(uint ee_addr, uint8_t *data, uint length);
   int read_int_from_eeprom(uint ee_addr);
+  bool crc_ok(const uint8_t *data);
+  bool read_cache(uint8_t *data);
+  void write_cache(const uint8_t *data);
+  static void write_cache_sector(void *cache);
   void calc_cal_coeffs(uint channel);
+  void build_note_table(uint channel);
   int read_eeprom();
   HardwareVersion probe_hardware_version();
 };
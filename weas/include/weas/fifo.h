@@ -21,8 +21,10 @@ private:
 };
 
 
-// responsible for launching code on core1 and connecting fifos
-// that send knob change events.
+// responsible for launching code on core1 and passing knob change events
+// to it.  events go through a CtrlRing in shared memory; the hardware fifo
+// is used only as a doorbell to wake core1 when the ring goes non-empty.
+// core1 then handles everything in the ring in one batch.
 
 // this is the basis for a UI using the knobs.
 
@@ -40,9 +42,12 @@ public:
 
   void set_ctrl_changes(CtrlHandler* k) {ctrl_changes = k;};
   void handle_ctrl_change(CtrlEvent event) override;
+  void handle_ctrl_tick() override;
   // void set_connected_changes(ConnectedHandler* c) {connected_changes = c;};
   // void handle_connected_change(uint8_t socket_in, bool connected) override;
   void start(Codec& cc);
+  [[nodiscard]] uint32_t get_drops() const {return ring.get_drops();};
+  [[nodiscard]] uint32_t get_coalesces() const {return ring.get_coalesces();};
 
 private:
 
@@ -52,9 +57,10 @@ private:
   CtrlHandler* ctrl_changes = nullptr;
   // ConnectedHandler* connected_changes = nullptr;
   void push(CtrlEvent);
+  void ring_doorbell();
   static void core1_marshaller();
   static constexpr uint TIMEOUT_US = 0;
-  CtrlQueue queue;
+  CtrlRing ring;
   patom::types::patomic_bool stalled;
 };
 
@@ -4,6 +4,7 @@
 
 
 #include "cosas/app.h"
+#include "cosas/crossfade.h"
 #include "cosas/filter.h"
 #include "cosas/knobs.h"
 #include "cosas/node.h"
@@ -37,7 +38,8 @@ public:
 
 private:
 
-  ATOMIC(RelSource*) source;
+  ATOMIC(SourcePair) sources;
+  ATOMIC(RelSource*) settled;  // incoming source once faded in (written by audio)
   ATOMIC(bool) source_access_flag;
   ATOMIC(TapMixin*) tap;
   App& app;
@@ -58,6 +60,8 @@ private:
   CtrlGate ctrl_gate = CtrlGate({4, 4, 4}, {128, 128, 128});
   KnobHandler source_knob = KnobHandler(1, 1, false, 0, 1);
   Codec& codec;  // used only during startup
+  Crossfade crossfade;  // audio only
+  RelSource* faded_to = nullptr;  // audio only
 
   void state_adjust(CtrlEvent event);
   void state_next_page(CtrlEvent event);
@@ -1,7 +1,11 @@
 
+#include <cstring>
+
 #include "weas/eeprom.h"
 
 #include "hardware/flash.h"
+#include "pico/flash.h"
+#include "pico/time.h"
 
 
 EEPROM::EEPROM() {
@@ -17,7 +21,10 @@ EEPROM::EEPROM() {
   gpio_init(USB_HOST_STATUS);
   gpio_disable_pulls(USB_HOST_STATUS);
 
+  uint64_t start = time_us_64();
   read_eeprom();
+  read_us = time_us_64() - start;
+  for (uint chan = 0; chan < N_CHANNELS; chan++) build_note_table(chan);
   flash_get_unique_id((uint8_t*)&unique_id);
 
   // Do some mixing up of the bits using full-cycle 64-bit LCG
@@ -69,19 +76,19 @@ EEPROM::HardwareVersion EEPROM::probe_hardware_version() {
 }
 
 
-uint8_t EEPROM::read_byte_from_eeprom(unsigned int ee_addr) {
+// sequential read (the address counter increments within the 256 byte block)
+void EEPROM::read_bytes_from_eeprom(uint ee_addr, uint8_t* data, uint length) {
   uint8_t device_addr = EEPROM_PAGE_ADDRESS | ((ee_addr >> 8) & 0x0F);
-  uint8_t data = 0xFF;
   uint8_t addr_low_byte = ee_addr & 0xFF;
-  i2c_write_blocking(i2c0, device_addr, &addr_low_byte, 1, false);
-  i2c_read_blocking(i2c0, device_addr, &data, 1, false);
-  return data;
+  memset(data, 0xFF, length);
+  i2c_write_blocking(i2c0, device_addr, &addr_low_byte, 1, true);
+  i2c_read_blocking(i2c0, device_addr, data, length, false);
 }
 
 int EEPROM::read_int_from_eeprom(unsigned int ee_addr) {
-  uint8_t highByte = read_byte_from_eeprom(ee_addr);
-  uint8_t lowByte = read_byte_from_eeprom(ee_addr + 1);
-  return (highByte << 8) | lowByte;
+  uint8_t bytes[2];
+  read_bytes_from_eeprom(ee_addr, bytes, 2);
+  return (bytes[0] << 8) | bytes[1];
 }
 
 uint16_t EEPROM::crc_encode(const uint8_t* data, uint length) {
@@ -109,17 +116,16 @@ int EEPROM::read_eeprom() {
     calibration_table[chan][2].dacSetting = 174400;
   }
 
-  if (read_int_from_eeprom(EEPROM_ADDR_ID) != EEPROM_VAL_ID) return 1;
   uint8_t buf[EEPROM_NUM_BYTES];
-  for (uint i = 0; i < EEPROM_NUM_BYTES; i++) {
-    buf[i] = read_byte_from_eeprom(i);
+  read_from_flash = read_cache(buf);
+  flash_copy_valid = read_from_flash;
+  if (!read_from_flash) {
+    if (read_int_from_eeprom(EEPROM_ADDR_ID) != EEPROM_VAL_ID) return 1;
+    read_bytes_from_eeprom(0, buf, EEPROM_NUM_BYTES);
+    if (!crc_ok(buf)) return 1;
+    write_cache(buf);
   }
 
-  uint16_t calculated_crc = crc_encode(buf, 86u);
-  uint16_t found_crc = ((uint16_t)buf[EEPROM_ADDR_CRC_H] << 8) | buf[EEPROM_ADDR_CRC_L];
-
-  if (calculated_crc != found_crc) return 1;
-
   int buffer_index = 4;
 
   for (uint8_t chan = 0; chan < N_CHANNELS; chan++) {
@@ -142,6 +148,39 @@ int EEPROM::read_eeprom() {
   return 0;
 }
 
+bool EEPROM::crc_ok(const uint8_t* data) {
+  uint16_t calculated_crc = crc_encode(data, 86u);
+  uint16_t found_crc = ((uint16_t)data[EEPROM_ADDR_CRC_H] << 8) | data[EEPROM_ADDR_CRC_L];
+  return calculated_crc == found_crc;
+}
+
+// the cached copy is used if it is intact and the id and crc in the eeprom
+// still match (two short reads instead of the whole block).
+bool EEPROM::read_cache(uint8_t* data) {
+  const Cache* cache = reinterpret_cast<const Cache*>(XIP_BASE + CACHE_OFFSET);
+  if (cache->magic != CACHE_MAGIC || !crc_ok(cache->data)) return false;
+  if (read_int_from_eeprom(EEPROM_ADDR_ID) != EEPROM_VAL_ID) return false;
+  uint8_t crc[2];
+  read_bytes_from_eeprom(EEPROM_ADDR_CRC_H, crc, 2);
+  if (crc[0] != cache->data[EEPROM_ADDR_CRC_H] || crc[1] != cache->data[EEPROM_ADDR_CRC_L]) return false;
+  memcpy(data, cache->data, EEPROM_NUM_BYTES);
+  return true;
+}
+
+void EEPROM::write_cache_sector(void* cache) {
+  flash_range_erase(CACHE_OFFSET, FLASH_SECTOR_SIZE);
+  flash_range_program(CACHE_OFFSET, static_cast<const uint8_t*>(cache), sizeof(Cache));
+}
+
+// flash_safe_execute disables interrupts and locks core1 out of flash if
+// it is running (see header).
+void EEPROM::write_cache(const uint8_t* data) {
+  Cache cache = {};
+  cache.magic = CACHE_MAGIC;
+  memcpy(cache.data, data, EEPROM_NUM_BYTES);
+  flash_copy_valid = flash_safe_execute(write_cache_sector, &cache, CACHE_TIMEOUT_MS) == PICO_OK;
+}
+
 void EEPROM::calc_cal_coeffs(uint channel) {
   float sum_v = 0.0;
   float sum_dac = 0.0;
@@ -169,11 +208,28 @@ void EEPROM::calc_cal_coeffs(uint channel) {
   cal_coeffs[channel].bi = static_cast<int32_t>(cal_coeffs[channel].b + 0.5f);
 }
 
+void EEPROM::build_note_table(uint channel) {
+  // signed (note - 60) so that notes below middle c are not wrapped
+  for (uint note = 0; note <= N_NOTES; note++) {
+    int32_t dacValue = ((cal_coeffs[channel].mi * (static_cast<int32_t>(note) - 60)) >> 4) + cal_coeffs[channel].bi;
+    if (dacValue > 524287) dacValue = 524287; // 19 bits
+    if (dacValue < 0) dacValue = 0;
+    note_table[channel][note] = dacValue;
+  }
+}
+
 uint32_t __not_in_flash_func(EEPROM::midi_to_dac)(Channel lr, uint note) {
-  int32_t dacValue = ((cal_coeffs[lr].mi * (note - 60)) >> 4) + cal_coeffs[lr].bi;
-  if (dacValue > 524287) dacValue = 524287; // 19 bits
-  if (dacValue < 0) dacValue = 0;
-  return dacValue;
+  return note_table[lr][note < N_NOTES ? note : N_NOTES - 1];
+}
+
+uint32_t __not_in_flash_func(EEPROM::frac_note_to_dac)(Channel lr, uint32_t note) {
+  constexpr uint32_t top = (N_NOTES - 1) << NOTE_FRAC_BITS;
+  if (note > top) note = top;
+  const uint32_t idx = note >> NOTE_FRAC_BITS;
+  const int32_t frac = static_cast<int32_t>(note & ((1u << NOTE_FRAC_BITS) - 1));
+  const int32_t lo = static_cast<int32_t>(note_table[lr][idx]);
+  const int32_t hi = static_cast<int32_t>(note_table[lr][idx + 1]);
+  return static_cast<uint32_t>(lo + (((hi - lo) * frac) >> NOTE_FRAC_BITS));
 }
 
 uint32_t __not_in_flash_func(EEPROM::midi_to_dac)(uint lr, uint note) {
@@ -187,3 +243,7 @@ void __not_in_flash_func(EEPROM::write_cv_midi_note)(Codec& cc, Channel lr, uint
 void __not_in_flash_func(EEPROM::write_cv_midi_note)(Codec& cc, uint lr, uint8_t note) {
   write_cv_midi_note(cc, static_cast<Channel>(lr), note);
 }
+
+void __not_in_flash_func(EEPROM::write_cv_frac_note)(Codec& cc, Channel lr, uint32_t note) {
+  cc.write_cv(lr, frac_note_to_dac(lr, note));
+}
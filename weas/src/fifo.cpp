@@ -1,4 +1,5 @@
 
+#include "pico/flash.h"
 #include "pico/multicore.h"
 
 #include "weas/fifo.h"
@@ -20,27 +21,22 @@ void FIFO::handle_ctrl_change(CtrlEvent event) {
 //   push(packed);
 // }
 
+// anything that spilled while the ring was full is moved across even when
+// the knobs are still.
+void FIFO::handle_ctrl_tick() {
+  if (ring.flush()) ring_doorbell();
+}
+
 void FIFO::push(CtrlEvent event) {
-  static uint write = 0, queued = 0;
-  write++;
-  if (stalled.Load()) {
-    queue.add(event);
-    queued++;
-    return;
-  } else {
-    while (!queue.empty()) {
-      CtrlEvent pending = queue.pop();
-      if (!multicore_fifo_push_timeout_us(pending.pack(), TIMEOUT_US)) {
-        queue.add(pending);
-        queue.add(event);
-        queued++;
-        return;
-      }
-    }
-    if (!multicore_fifo_push_timeout_us(event.pack(), TIMEOUT_US)) {
-      queue.add(event);
-      queued++;
-    }
+  if (ring.push(event)) ring_doorbell();
+}
+
+void FIFO::ring_doorbell() {
+  // if stalled, core1 is busy handling an earlier event and will check the
+  // ring again before waiting, so there's no need to wake it.
+  if (!stalled.Load()) {
+    // if the hardware fifo is full then core1 already has a doorbell waiting
+    multicore_fifo_push_timeout_us(Header::Ctrl, TIMEOUT_US);
   }
 }
 
@@ -49,12 +45,13 @@ void FIFO::core1_marshaller() {
   try {
     // exceptions used only for diagnostics
     // see docs on multi core exception problems
+    flash_safe_execute_core_init();  // so core0 can lock us out to write flash
     auto& fifo = get();
-    uint read = 0;
+    CtrlEvent event;
     while (true) {
-      read++;
-      uint32_t packed = multicore_fifo_pop_blocking();  // blocking wait
-      fifo.ctrl_changes->handle_ctrl_change(CtrlEvent::unpack(packed));
+      multicore_fifo_pop_blocking();  // blocking wait for doorbell
+      multicore_fifo_drain();  // any other doorbells are covered by this batch
+      while (fifo.ring.pop(event)) fifo.ctrl_changes->handle_ctrl_change(event);
     }
   } catch (std::exception& e) {
     Debug::log(e.what());
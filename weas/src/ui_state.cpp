@@ -12,17 +12,23 @@
 UIState::UIState(App& app, FIFO& fifo,  Codec& codec)
   : CtrlHandler(), app(app), fifo(fifo), leds_buffer(LEDsBuffer::get()),
     leds_mask(leds_buffer.leds_mask.get()), codec(codec) {
-  source = nullptr;
+  sources = SourcePair();
+  settled = nullptr;
   tap = nullptr;
 }
 
 void UIState::per_sample_cb(Codec &codec) {
-  RelSource* s = LOAD(source);
+  const SourcePair p = LOAD(sources);
   source_access_flag = true;
-  if (s) {
-    codec.write_audio(Right, s->next(0));
+  if (p.incoming != faded_to) {
+    faded_to = p.incoming;
+    crossfade.start();
+  }
+  if (p.incoming) {
+    codec.write_audio(Right, crossfade.next(p));
     TapMixin* t = LOAD(tap);
     codec.write_audio(Left, t ? t->prev() : 0);
+    if (!crossfade.active() && LOAD(settled) != faded_to) settled = faded_to;
   }
 };
 
@@ -79,7 +85,7 @@ void UIState::state_adjust(CtrlEvent event) {
       auto stalled = Stalled(fifo);
       KnobChange change = current_page_knobs[event.ctrl]->handle_knob_change(event.now, event.prev);
       // KnobChange change = current_page_knobs[event.ctrl]->handle_knob_change(0, 0);
-      uint32_t ring = leds_mask->ring(change.normalized, change.highlight);
+      uint32_t ring = leds_mask->ring_fixed(change.position >> (KnobHandler::POSITION_BITS - BaseLEDsMask::RING_BITS), change.highlight);
       leds_buffer.queue(ring, false, false, 0);
     } else {
       leds_buffer.queue(INVALID_KNOB, false, false, 0);
@@ -135,13 +141,21 @@ void UIState::state_next_page(CtrlEvent event) {
 }
 
 void UIState::update_source() {
-  source = nullptr;
+  RelSource* current = LOAD(sources).incoming;
+  // wait for any earlier fade to finish, so at most two sources are in use
+  while (current && LOAD(settled) != current) sleep_ms(1);
   tap = nullptr;
-  source_access_flag = false;
-  while (!LOAD(source_access_flag)) sleep_ms(1);
-  // here core 0 has hit the null source and so is no longer accessing the
-  // old value and we can safely delete
-  source = app.get_source(source_idx);
+  if (app.retains_sources()) {
+    // old source is still valid, so the audio core can fade between them
+    sources = SourcePair(app.get_source(source_idx), current);
+  } else {
+    sources = SourcePair();
+    source_access_flag = false;
+    while (!LOAD(source_access_flag)) sleep_ms(1);
+    // here core 0 has hit the null source and so is no longer accessing the
+    // old value and we can safely delete
+    sources = SourcePair(app.get_source(source_idx), nullptr);
+  }
   page = 0;
   update_page();
 }